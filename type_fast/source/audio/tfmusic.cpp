@@ -24,14 +24,16 @@
 
 #include "tfmusic.hpp"
 
+#include <cstring>
 #include "../util/util.hpp"
+#include "../platform/platform.hpp"
 
 namespace tf
 {
 
 Tfmusic::Tfmusic(const char* music_path)
 {
-    m_music = LoadMusicStream(music_path);
+    m_music = platform::load_music(music_path);
 
     const long pathlen = static_cast<int>(strlen(music_path));
     long offset = pathlen;
@@ -53,42 +55,42 @@ Tfmusic& Tfmusic::operator=(Tfmusic&& other)
 
 Tfmusic::~Tfmusic()
 {
-    if (m_music) UnloadMusicStream(m_music);
+    if (m_music) platform::unload_music(m_music);
 }
 
 void Tfmusic::update() const
 {
-    UpdateMusicStream(m_music);
+    platform::update_music(m_music);
 }
 
 void Tfmusic::play() const
 {
-    PlayMusicStream(m_music);
+    platform::play_music(m_music);
 }
 
 void Tfmusic::pause() const
 {
-    PauseMusicStream(m_music);
+    platform::pause_music(m_music);
 }
 
 void Tfmusic::resume() const
 {
-    ResumeMusicStream(m_music);
+    platform::resume_music(m_music);
 }
 
 void Tfmusic::stop() const
 {
-    StopMusicStream(m_music);
+    platform::stop_music(m_music);
 }
 
 bool Tfmusic::is_playing() const
 {
-    return IsMusicPlaying(m_music);
+    return platform::is_music_playing(m_music);
 }
 
 void Tfmusic::set_volume(float volume) const
 {
-    SetMusicVolume(m_music, clamp(volume, 0.0f, 1.0f));
+    platform::set_music_volume(m_music, clamp(volume, 0.0f, 1.0f));
 }
 
 }
@@ -25,13 +25,14 @@
 #include "tfsound.hpp"
 
 #include <string.h>
+#include "../platform/platform.hpp"
 
 namespace tf
 {
 
 Tfsound::Tfsound(const char* sound_path)
 {
-    m_sound = LoadSound(sound_path);
+    m_sound = platform::load_sound(sound_path);
 
     const long pathlen = static_cast<int>(strlen(sound_path));
     long offset = pathlen;
@@ -43,32 +44,32 @@ Tfsound::Tfsound(const char* sound_path)
 
 Tfsound::~Tfsound()
 {
-    UnloadSound(m_sound);
+    platform::unload_sound(m_sound);
 }
 
 void Tfsound::play() const
 {
-    PlaySound(m_sound);
+    platform::play_sound(m_sound);
 }
 
 void Tfsound::pause() const
 {
-    PauseSound(m_sound);
+    platform::pause_sound(m_sound);
 }
 
 void Tfsound::resume() const
 {
-    ResumeSound(m_sound);
+    platform::resume_sound(m_sound);
 }
 
 void Tfsound::stop() const
 {
-    StopSound(m_sound);
+    platform::stop_sound(m_sound);
 }
 
 bool Tfsound::is_playing() const
 {
-    return IsSoundPlaying(m_sound);
+    return platform::is_sound_playing(m_sound);
 }
 
 }
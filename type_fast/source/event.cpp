@@ -27,70 +27,68 @@
 #include <string.h>
 #include "util/assert.hpp"
 #include "util/types.hpp"
+#include "util/compat.hpp"
 #include <cstring>
 
 namespace tf
 {
 
-Event Event::create_word_input(const char* word)
+Event Event::create_word_input(const char* word, const u64 time_us)
 {
-    Event_word_input* event_data = new Event_word_input;
-    const auto res = strcpy_s(event_data->word, event_data->size, word);
+    Event event{Event_type::word_input};
+    const auto res = strcpy_s(event.data.word_input.word, Event_word_input::size, word);
     tf_assert(res == 0, "copy word to event");
-
-    Event event{Event_type::word_input, event_data};
+    event.data.word_input.time_us = time_us;
     return event;
 }
 
 Event Event::create_word_missed(const char* word)
 {
-    Event_word_missed* event_data = new Event_word_missed;
-    const auto res = strcpy_s(event_data->word, event_data->size, word);
+    Event event{Event_type::word_missed};
+    const auto res = strcpy_s(event.data.word_missed.word, Event_word_missed::size, word);
     tf_assert(res == 0, "copy word to event");
-
-    Event event{Event_type::word_missed, event_data};
     return event;
 }
 
-Event Event::create_word_hit(const char* word)
+Event Event::create_word_hit(const char* word, const u64 time_us, const int edits)
 {
-    Event_word_hit* event_data = new Event_word_hit;
-    const auto res = strcpy_s(event_data->word, event_data->size, word);
+    Event event{Event_type::word_hit};
+    const auto res = strcpy_s(event.data.word_hit.word, Event_word_hit::size, word);
     tf_assert(res == 0, "copy word to event");
-
-    Event event{Event_type::word_hit, event_data};
+    event.data.word_hit.edits = edits;
+    event.data.word_hit.time_us = time_us;
     return event;
 }
 
-Event Event::create_first_letter_input(const char* letter, const size_t bytes)
+Event Event::create_first_letter_input(const char* letter, const size_t bytes,
+                                        const u64 time_us)
 {
-    tf_assert(bytes <= sizeof(Event_first_letter_input),
+    tf_assert(bytes <= sizeof(Event_first_letter_input::letter),
               "could not fit letter in Event_first_letter_input struct");
-    Event event{Event_type::first_letter_input, nullptr};
-    std::memcpy(&event.data, letter, bytes);
+    Event event{Event_type::first_letter_input};
+    std::memcpy(event.data.first_letter_input.letter, letter, bytes);
+    event.data.first_letter_input.time_us = time_us;
     return event;
 }
 
 const Event_word_input* Event::get_word_input() const
 {
-    return static_cast<Event_word_input*>(this->data);
+    return &this->data.word_input;
 }
 
 const Event_word_missed* Event::get_word_missed() const
 {
-    return static_cast<Event_word_missed*>(this->data);
+    return &this->data.word_missed;
 }
 
 const Event_word_hit* Event::get_word_hit() const
 {
-    return static_cast<Event_word_hit*>(this->data);
+    return &this->data.word_hit;
 }
 
 const Event_first_letter_input Event::get_first_letter_input() const
 {
-    Event_first_letter_input data{};
-    std::memcpy(&data, &this->data, sizeof(Event_first_letter_input));
-    return data;
+    return this->data.first_letter_input;
 }
 
 }
@@ -29,6 +29,7 @@
 // Headers
 // ============================================================ //
 
+#include <type_traits>
 #include "widget/constants.hpp"
 #include "util/types.hpp"
 
@@ -52,6 +53,8 @@ enum class Event_type
     first_letter_input
 };
 
+constexpr size_t event_type_count = (size_t)Event_type::first_letter_input + 1;
+
 // ============================================================ //
 // Event data
 // ============================================================ //
@@ -60,6 +63,7 @@ struct Event_word_input
 {
     static constexpr int size = constants::word_size;
     char word[size];
+    u64 time_us; // when the word was submitted, see now_us
 };
 
 struct Event_word_missed
@@ -72,18 +76,25 @@ struct Event_word_hit
 {
     static constexpr int size = constants::word_size;
     char word[size];
+    int edits; // edits away from the input, 0 unless accepted with typos
+    u64 time_us; // when the word was submitted
 };
 
 struct Event_first_letter_input
 {
     char8 letter[4]; // UTF-8 letter
-}; static_assert(sizeof(Event_first_letter_input) <= sizeof(void*),
-                 "Event_first_letter_input must fit in void*");
+    u64 time_us; // when the key was pressed
+};
 
 // ============================================================ //
 // Event
 // ============================================================ //
 
+/**
+ * Tagged union of the event data. The data lives inline, so creating,
+ * copying and destroying events never touches the allocator, and a vector of
+ * events can grow with a plain memcpy.
+ */
 class Event
 {
 public:
@@ -92,16 +103,20 @@ public:
     // ============================================================ //
     /**
      * @param word Null terminated string
+     * @param time_us Keystroke timestamp, see now_us
      */
-    static Event create_word_input(const char* word);
+    static Event create_word_input(const char* word, const u64 time_us);
     static Event create_word_missed(const char* word);
-    static Event create_word_hit(const char* word);
+    static Event create_word_hit(const char* word, const u64 time_us,
+                                 const int edits = 0);
     /**
      * Note, letters are encoded as UTF-8.
      * @param letter Pointer to where the letter begins
      * @param bytes How many bytes the letter is
+     * @param time_us Keystroke timestamp
      */
-    static Event create_first_letter_input(const char* letter, const size_t bytes);
+    static Event create_first_letter_input(const char* letter, const size_t bytes,
+                                           const u64 time_us);
 
     // ============================================================ //
     // Getters
@@ -116,59 +131,29 @@ public:
     // ============================================================ //
     // Lifetime
     // ============================================================ //
-private:
-    Event() : type(Event_type::none), data(nullptr) {}
-    Event(Event_type type, void* data) : type(type), data(data) {}
+    /**
+     * Event of type none, use the factory functions to create real events.
+     */
+    Event() : type(Event_type::none), data{} {}
 
-public:
-    // no copy, because why
-    Event(const Event& other) = delete;
-    Event& operator=(const Event& other) = delete;
-
-    Event(Event&& other) noexcept : type(other.type), data(other.data)
-        {
-            other.data = nullptr;
-        };
-    Event& operator=(Event&& other) noexcept
-        {
-            if (this != &other) {
-                this->type = other.type;
-                this->data = other.data;
-                other.data = nullptr;
-            }
-            return *this;
-        }
-
-    // RAII free our data
-    ~Event()
-        {
-            switch (this->type) {
-            case Event_type::word_input: {
-                delete (Event_word_input*)this->data;
-                break;
-            }
-            case Event_type::word_missed: {
-                delete (Event_word_missed*)this->data;
-                break;
-            }
-            case Event_type::word_hit: {
-                delete (Event_word_hit*)this->data;
-                break;
-            }
-            case Event_type::first_letter_input:
-            case Event_type::none: {
-                break;
-            }
-            }
-        }
+private:
+    explicit Event(Event_type type) : type(type), data{} {}
 
     // ============================================================ //
     // Variables
     // ============================================================ //
 private:
     Event_type type;
-    void* data;
+    union Data
+    {
+        Event_word_input word_input;
+        Event_word_missed word_missed;
+        Event_word_hit word_hit;
+        Event_first_letter_input first_letter_input;
+    } data;
 };
+static_assert(std::is_trivially_copyable<Event>::value,
+              "Event must be trivially copyable");
 
 }
 
@@ -0,0 +1,116 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __EVENT_BUFFER_HPP__
+#define __EVENT_BUFFER_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <cstddef>
+#include "event.hpp"
+#include "widget/constants.hpp"
+#include "util/types.hpp"
+
+// ============================================================ //
+// Class
+// ============================================================ //
+
+namespace tf
+{
+
+/**
+ * Fixed capacity arena for the events of one frame. Events are trivially
+ * copyable, so clearing is O(1) and nothing is ever allocated. When full,
+ * new events are dropped and counted as overflow, the F3 overlay shows the
+ * count next to the high water mark.
+ */
+template <size_t TCapacity>
+class Event_buffer
+{
+public:
+    /**
+     * @return If the event fit, else it was dropped.
+     */
+    bool push_back(const Event& event)
+        {
+            if (m_size == TCapacity) {
+                m_overflow++;
+                return false;
+            }
+            m_events[m_size++] = event;
+            m_counts[(size_t)event.get_type()]++;
+            if (m_size > m_high_water) m_high_water = m_size;
+            return true;
+        }
+
+    void clear()
+        {
+            m_size = 0;
+            for (auto& count : m_counts) count = 0;
+        }
+
+    /**
+     * Call @fn with every event of type @type, in the order they were pushed.
+     */
+    template <typename Fn>
+    void for_each(Event_type type, Fn&& fn) const
+        {
+            for (size_t i = 0; i < m_size; i++) {
+                if (m_events[i].get_type() == type) fn(m_events[i]);
+            }
+        }
+
+    const Event* begin() const { return m_events; }
+    const Event* end() const { return m_events + m_size; }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    size_t count(Event_type type) const { return m_counts[(size_t)type]; }
+    static constexpr size_t capacity() { return TCapacity; }
+
+    /**
+     * Total number of dropped events.
+     */
+    u64 overflow_count() const { return m_overflow; }
+
+    /**
+     * Most events held at once.
+     */
+    size_t high_water() const { return m_high_water; }
+
+private:
+    alignas(64) Event m_events[TCapacity];
+    size_t m_size = 0;
+    size_t m_counts[event_type_count]{};
+    size_t m_high_water = 0;
+    u64 m_overflow = 0;
+};
+
+using Frame_events = Event_buffer<constants::max_frame_events>;
+
+}
+
+#endif//__EVENT_BUFFER_HPP__
@@ -0,0 +1,155 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __EVENT_BUS_HPP__
+#define __EVENT_BUS_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <tuple>
+#include <utility>
+#include <type_traits>
+#include "event.hpp"
+
+// ============================================================ //
+// Event traits
+// ============================================================ //
+
+namespace tf
+{
+
+/**
+ * Maps an event type to its data struct.
+ */
+template <Event_type TType>
+struct Event_traits;
+
+template <>
+struct Event_traits<Event_type::word_input>
+{
+    using Data = Event_word_input;
+    static const Data& get(const Event& event) { return *event.get_word_input(); }
+};
+
+template <>
+struct Event_traits<Event_type::word_missed>
+{
+    using Data = Event_word_missed;
+    static const Data& get(const Event& event) { return *event.get_word_missed(); }
+};
+
+template <>
+struct Event_traits<Event_type::word_hit>
+{
+    using Data = Event_word_hit;
+    static const Data& get(const Event& event) { return *event.get_word_hit(); }
+};
+
+template <>
+struct Event_traits<Event_type::first_letter_input>
+{
+    using Data = Event_first_letter_input;
+    static Data get(const Event& event) { return event.get_first_letter_input(); }
+};
+
+/**
+ * If @TSubscriber has a on_event(const Data&) overload for @TType.
+ */
+template <typename TSubscriber, Event_type TType, typename = void>
+struct Handles_event : std::false_type {};
+
+template <typename TSubscriber, Event_type TType>
+struct Handles_event<TSubscriber, TType, std::void_t<
+    decltype(std::declval<TSubscriber&>().on_event(
+                 std::declval<const typename Event_traits<TType>::Data&>()))>>
+    : std::true_type {};
+
+// ============================================================ //
+// Class
+// ============================================================ //
+
+/**
+ * Routes events to every subscriber with a matching on_event overload. Which
+ * subscriber handles which type is decided at compile time, there are no
+ * function pointers or virtual calls.
+ *
+ * Events are dispatched in batches, one type at a time, and every subscriber
+ * of that type sees the whole batch before the next subscriber runs. Types
+ * are dispatched in the order listed in dispatch, which puts causes before
+ * effects. Events pushed while dispatching are seen if their type has not
+ * been dispatched yet.
+ */
+template <typename... TSubscribers>
+class Event_bus
+{
+public:
+    explicit Event_bus(TSubscribers&... subscribers)
+        : m_subscribers(subscribers...) {}
+
+    /**
+     * Dispatch every event in @events, an Event_buffer.
+     */
+    template <typename TBuffer>
+    void dispatch(const TBuffer& events)
+        {
+            // typing started before any word of the same frame was entered
+            dispatch_type<Event_type::first_letter_input>(events);
+            // pushes word_hit
+            dispatch_type<Event_type::word_input>(events);
+            dispatch_type<Event_type::word_missed>(events);
+            dispatch_type<Event_type::word_hit>(events);
+        }
+
+private:
+    template <Event_type TType, typename TBuffer>
+    void dispatch_type(const TBuffer& events)
+        {
+            if (events.count(TType) == 0) return;
+            dispatch_type<TType>(events, std::index_sequence_for<TSubscribers...>{});
+        }
+
+    template <Event_type TType, typename TBuffer, size_t... TIndices>
+    void dispatch_type(const TBuffer& events, std::index_sequence<TIndices...>)
+        {
+            (dispatch_batch<TType>(std::get<TIndices>(m_subscribers), events), ...);
+        }
+
+    template <Event_type TType, typename TSubscriber, typename TBuffer>
+    static void dispatch_batch(TSubscriber& subscriber, const TBuffer& events)
+        {
+            if constexpr (Handles_event<TSubscriber, TType>::value) {
+                events.for_each(TType, [&subscriber](const Event& event) {
+                        subscriber.on_event(Event_traits<TType>::get(event));
+                    });
+            }
+        }
+
+    std::tuple<TSubscribers&...> m_subscribers;
+};
+
+}
+
+#endif//__EVENT_BUS_HPP__
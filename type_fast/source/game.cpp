@@ -25,42 +25,204 @@
 #include "game.hpp"
 
 #include <cassert>
-#include "thirdparty/dutil/stopwatch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "util/assert.hpp"
+#include "util/compat.hpp"
 
 namespace tf
 {
 
+/**
+ * @value as it's printed with @decimals, for Word_formatter::version_fn.
+ */
+static u64 printed(double value, int decimals)
+{
+    return static_cast<u64>(std::llround(value * std::pow(10.0, decimals)));
+}
+
 Game::~Game()
 {
     // UnloadTexture(gnome);
-    UnloadFont(m_font);
+    m_keys.stop();
+    if (events.overflow_count() > 0) {
+        printf("events dropped: %llu, raise constants::max_frame_events\n",
+               static_cast<unsigned long long>(events.overflow_count()));
+    }
+    if (m_latency.histogram(Latency_tracker::present).count() > 0) {
+        m_latency.export_csv(latency_file);
+    }
+    platform::unload_font(m_font);
 }
 
 void Game::run()
 {
-    while (!WindowShouldClose()) {
+    if (!m_pipelined) {
+        while (!platform::should_close()) {
+            m_limiter.begin_frame();
+            sample_input();
+            updatetime.start();
+            update();
+            updatetime.stop();
+            updatetime_last = updatetime.fms();
+            take_snapshot(m_snapshots[0]);
+            draw(m_snapshots[0]);
+            m_limiter.end_frame();
+            presented(m_snapshots[0], now_us());
+            pace();
+        }
+        return;
+    }
+
+    // main thread samples input and draws frame N, while frame N+1 is
+    // simulated. They meet once per frame to swap snapshots.
+    m_simulation_quit = false;
+    m_simulation = std::thread(&Game::run_simulation, this);
+    const auto simulate = [this]() {
+        {
+            std::lock_guard<std::mutex> lock{m_simulation_mutex};
+            m_simulate = true;
+        }
+        m_simulation_cv.notify_all();
+    };
+    const auto wait_for_simulation = [this]() {
+        std::unique_lock<std::mutex> lock{m_simulation_mutex};
+        m_simulation_cv.wait(lock, [this]() { return !m_simulate; });
+    };
+
+    sample_input();
+    simulate();
+    wait_for_simulation();
+    while (!platform::should_close()) {
+        const int front = m_back;
+        m_back = 1 - m_back;
+        m_limiter.begin_frame();
+        sample_input();
+        simulate();
+        draw(m_snapshots[front]);
+        const u64 presented_us = now_us();
+        m_limiter.end_frame();
+        wait_for_simulation();
+        presented(m_snapshots[front], presented_us);
+        pace();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{m_simulation_mutex};
+        m_simulation_quit = true;
+    }
+    m_simulation_cv.notify_all();
+    m_simulation.join();
+}
+
+void Game::run_simulation()
+{
+    std::unique_lock<std::mutex> lock{m_simulation_mutex};
+    for (;;) {
+        m_simulation_cv.wait(lock, [this]() { return m_simulate || m_simulation_quit; });
+        if (m_simulation_quit) break;
+        lock.unlock();
+
         updatetime.start();
         update();
         updatetime.stop();
         updatetime_last = updatetime.fms();
-        draw();
+        take_snapshot(m_snapshots[m_back]);
+
+        lock.lock();
+        m_simulate = false;
+        m_simulation_cv.notify_all();
+    }
+}
+
+void Game::sample_input()
+{
+    if (platform::is_key_pressed(KEY_F11)) { platform::toggle_fullscreen(); }
+    if (platform::is_key_pressed(KEY_F5)) {
+        m_limiter.set_latency_mode(!m_limiter.latency_mode());
+        m_limiter.reset_stats();
+    }
+    m_input.toggle_latency = platform::is_key_pressed(KEY_F3);
+    m_input.export_latency = platform::is_key_pressed(KEY_F4);
+    Mouse_state& mouse = m_input.mouse;
+    const Vector2 last_pos = mouse.pos;
+    const bool last_pressed = mouse.left_pressed;
+    const bool last_down = mouse.left_down;
+    mouse.left_pressed = platform::is_mouse_pressed(MOUSE_LEFT_BUTTON);
+    mouse.left_down = platform::is_mouse_down(MOUSE_LEFT_BUTTON);
+    mouse.pos = platform::mouse_position();
+    const bool mouse_moved = mouse.pos.x != last_pos.x || mouse.pos.y != last_pos.y;
+    if (mouse_moved || mouse.left_pressed != last_pressed || mouse.left_down != last_down) {
+        mouse.version++;
+    }
+    m_input.frame_time = platform::frame_time();
+    m_input.time_us = platform::time_us();
+    m_keys.poll();
+    update_audio();
+
+    if (mouse_moved || mouse.left_down || !m_keys.empty()) {
+        m_pacer.activity(m_input.time_us);
+    }
+}
+
+void Game::take_snapshot(Render_snapshot& snapshot)
+{
+    snapshot.words.assign(words.begin(), words.end());
+    snapshot.texts.assign(texts.begin(), texts.end());
+    snapshot.word_formatters.assign(word_formatters.begin(), word_formatters.end());
+    hscroll_words.copy_to(snapshot.hscroll_words);
+    snapshot.rects.assign(rects.begin(), rects.end());
+    snapshot.buttons.assign(buttons.begin(), buttons.end());
+    snapshot.sliders.assign(sliders.begin(), sliders.end());
+    snapshot.hscroll_rects.clear();
+    hscroll_rects.for_each([&snapshot](const H_scroll<Rect>& hscroll_rect) {
+        snapshot.hscroll_rects.push_back(hscroll_rect);
+    });
+    snapshot.input_box = m_input_box;
+    snapshot.alpha = m_alpha;
+    snapshot.show_latency = m_show_latency;
+    snapshot.events_high_water = events.high_water();
+    snapshot.events_dropped = events.overflow_count();
+    snapshot.key_count = m_latency.key_count();
+    std::memcpy(snapshot.capture_us, m_latency.capture_times(),
+                snapshot.key_count * sizeof(u64));
+}
+
+void Game::pace()
+{
+    const int fps = m_pacer.fps();
+    if (m_pacer.update(m_input.time_us, m_animating) != fps) {
+        m_limiter.set_target_fps(m_pacer.fps());
     }
 }
 
+void Game::presented(const Render_snapshot& snapshot, u64 time_us)
+{
+    m_latency.add(Latency_tracker::present, time_us, snapshot.capture_us,
+                  snapshot.key_count);
+}
+
 void Game::setup(int width, int height, const char* title, int target_fps,
                  const char* font, const char* text_file)
 {
     m_width = width;
     m_height = height;
-    SetWindowSize(width, height);
-    SetWindowTitle(title);
-    SetTargetFPS(target_fps);
-    m_font = LoadFontEx(font, 96, 224, NULL);
-    SetTextureFilter(m_font.texture, FILTER_BILINEAR);
+    platform::set_window_size(width, height);
+    platform::set_window_title(title);
+    // paced by m_limiter instead
+    platform::set_target_fps(0);
+    m_limiter.set_vsync(platform::vsync());
+    m_limiter.set_target_fps(target_fps);
+    m_pacer = Frame_pacer{target_fps, 30, 10};
+    m_pacer.set_enabled(target_fps > 0);
+    m_font = platform::load_font(font, 96);
 
     load_word_generator(text_file);
 
     setup_start_objects();
+
+    m_keys.start();
 }
 
 void Game::setup_start_objects()
@@ -94,10 +256,29 @@ void Game::setup_start_objects()
             [](Slider& slider){
                 Game& game = Game::instance();
                 game.m_wpm = slider.value;
+                game.m_timers.cancel(game.m_apply_wpm_timer);
+                game.m_apply_wpm_timer = game.m_timers.schedule(
+                    game.m_sim_time_us + wpm_debounce_us, Game_timer::apply_wpm);
             },
             wpm_default, 1, 170, true)
         );
 
+    // keystroke latency, F3 shows the histogram
+    word_formatters.push_back({
+            {"", tf::col_white, 20, {10, (float)m_height - 130}},
+            [](tf::Word_formatter* wf) {
+                const Latency_histogram& latency =
+                    Game::instance().m_latency.histogram(Latency_tracker::present);
+                sprintf_s(wf->handle.text, wf->handle.text_size,
+                          "latency p50 %.1fms p99 %.1fms",
+                          latency.percentile_us(0.5) / 1000.0,
+                          latency.percentile_us(0.99) / 1000.0);
+            },
+            []() -> u64 {
+                return Game::instance().m_latency.histogram(Latency_tracker::present).count();
+            }
+        });
+
     // wpm counter
     Vector2 wpm_stats_pos{10, 30};
     word_formatters.push_back({
@@ -105,18 +286,20 @@ void Game::setup_start_objects()
             [](tf::Word_formatter* wf) {
                 sprintf_s(wf->handle.text, wf->handle.text_size,
                           "wpm %.1f", Game::instance().get_wpm());
-            }
+            },
+            []() -> u64 { return printed(Game::instance().get_wpm(), 1); }
         });
     word_formatters.push_back({
             {"", tf::col_white, 20, {wpm_stats_pos.x, wpm_stats_pos.y + 20}},
             [](tf::Word_formatter* wf) {
                 sprintf_s(wf->handle.text, wf->handle.text_size,
                           "adjusted wpm %.1f", Game::instance().get_adjusted_wpm());
-            }
+            },
+            []() -> u64 { return printed(Game::instance().get_adjusted_wpm(), 1); }
         });
 
     // Title
-    const float tfwidth = MeasureTextEx(m_font, "Type Fast", 50, 0).x;
+    const float tfwidth = platform::measure_text(m_font, "Type Fast", 50, 0).x;
     words.push_back({ "Type Fast", tf::col_red, 50, {m_width/2 - tfwidth/2, 10} });
 
     // Frametime
@@ -125,11 +308,17 @@ void Game::setup_start_objects()
         ({{"", tf::col_white, 20, {fps_x, 0}},
           [](tf::Word_formatter* wf) {
               sprintf_s(wf->handle.text, wf->handle.text_size,
-                        "Frametime %.2fms, Update %.2fms", GetFrameTime()*1000,
+                        "Frametime %.2fms, Update %.2fms",
+                        Game::instance().m_input.frame_time*1000,
                         Game::instance().updatetime_last);
+          },
+          []() -> u64 {
+              const Game& game = Game::instance();
+              return printed(game.m_input.frame_time * 1000.0, 2) << 32 |
+                  printed(game.updatetime_last, 2);
           }
         });
-    const float fps_width = MeasureTextEx(
+    const float fps_width = platform::measure_text(
         m_font, "Frametime 12.73ms, Update 0.13ms", 20, 0
         ).x;
 
@@ -138,7 +327,9 @@ void Game::setup_start_objects()
         ({{"", tf::col_white, 20, {fps_x + fps_width, 0}},
           [](tf::Word_formatter* wf) {
               sprintf_s(wf->handle.text, wf->handle.text_size,
-                        "mouse %d:%d", GetMouseX(), GetMouseY());}
+                        "mouse %d:%d", (int)Game::instance().m_input.mouse.pos.x,
+                        (int)Game::instance().m_input.mouse.pos.y);},
+          []() -> u64 { return Game::instance().m_input.mouse.version; }
         });
 
     // Music
@@ -159,6 +350,18 @@ void Game::setup_start_objects()
             0, 0, 100, true)
         );
 
+    // difficulty slider, only words up to this percentile of typing cost
+    Rectangle difficulty_slider_pos{10, (float)m_height - 150, 150, 50};
+    sliders.push_back(
+        create_slider(
+            difficulty_slider_pos, "difficulty %d", tf::col_orange,
+            [](Slider& slider) {
+                Game& game = Game::instance();
+                game.m_wordgen.set_difficulty(0.0f, slider.value / 100.0f);
+            },
+            100, 1, 100, true)
+        );
+
     // ============================================================ //
     // Dummy objects
     // ============================================================ //
@@ -171,121 +374,265 @@ void Game::setup_start_objects()
 
 void Game::update()
 {
-    if (IsKeyPressed(KEY_F11)) { ToggleFullscreen(); }
+    if (m_input.toggle_latency) { m_show_latency = !m_show_latency; }
+    if (m_input.export_latency) {
+        if (m_latency.export_csv(latency_file)) printf("latency saved to %s\n", latency_file);
+    }
+
+    if (m_replaying) read_replay_frame();
+    else {
+        m_time_us = m_input.time_us;
+        m_journal.frame(m_time_us);
+    }
 
-    update_audio();
     update_game_objects();
     handle_events();
 }
 
 void Game::update_game_objects()
 {
-    // Spawn new word
-    if (GetTime() - m_wpm_timer > 60.0 / m_wpm) {
-        m_wpm_timer = GetTime();
-        spawn_word();
+    // fixed ticks for the last frame time, the remainder is drawn interpolated
+    m_frame_ticks = advance_ticks();
+
+    const size_t key_count = drain_keystrokes();
+    if (key_count > 0) {
+        m_timers.cancel(m_spawn_pause_timer);
+        m_spawn_pause_timer = m_timers.schedule(m_sim_time_us + spawn_idle_after_us,
+                                                Game_timer::spawn_pause);
+        if (!m_timers.is_scheduled(m_spawn_timer)) {
+            m_spawn_timer = m_timers.schedule(m_sim_time_us, Game_timer::spawn_word);
+        }
     }
-
-    m_wpm_stats.update();
-
-    const bool is_left_pressed = IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
-    const bool is_left_down = IsMouseButtonDown(MOUSE_LEFT_BUTTON);
-    const Vector2 cpos = GetMousePosition();
-
-    tf::update(m_input_box, events);
+    m_latency.begin_frame(m_keystrokes, key_count);
+    tf::update(m_input_box, m_keystrokes, key_count, events);
+    m_latency.mark(Latency_tracker::input);
     for (auto& formatter : word_formatters) {
         tf::update(formatter);
     }
-    for (auto& button : buttons) {
-        tf::update(button, cpos, is_left_pressed);
-    }
-    for (auto it = hscroll_words.begin(); it != hscroll_words.end();) {
-        if (tf::update(it->second, (float)m_width)) {
-            events.push_back(
-                Event::create_word_missed(it->second.drawable.handle.text));
-            it = hscroll_words.erase(it);
+    if (m_replaying) apply_replay_records(Journal_record_type::reset);
+    else {
+        for (auto& button : buttons) {
+            tf::update(button, m_input.mouse);
         }
-        else it++;
     }
-    for (auto& hscroll_rect : hscroll_rects) {
-        tf::update(hscroll_rect, (float)m_width);
+
+    for (u64 i = 0; i < m_frame_ticks; i++) {
+        tick();
     }
-    for (auto& slider : sliders) {
-        tf::update(slider, cpos, is_left_down);
+    // after the ticks, so words spawned during the frame aren't moved twice
+    m_timers.advance(m_sim_time_us, [this](Game_timer timer, u64 deadline_us) {
+        on_timer(timer, deadline_us);
+    });
+    hscroll_words.highlight(match_input(), m_input_box.text_input.version);
+    m_latency.mark(Latency_tracker::highlight);
+
+    m_animating = !hscroll_words.empty() || !hscroll_rects.empty();
+
+    if (m_replaying) apply_replay_records(Journal_record_type::slider);
+    else {
+        for (size_t i = 0; i < sliders.size(); i++) {
+            const int value = sliders[i].value;
+            tf::update(sliders[i], m_input.mouse);
+            if (sliders[i].value != value) {
+                m_journal.slider(static_cast<u32>(i), sliders[i].value);
+            }
+        }
     }
 }
 
-void Game::update_audio()
+u64 Game::advance_ticks()
 {
-    music.update();
+    const u64 frame_us = m_last_frame_us != 0 ? m_time_us - m_last_frame_us : 0;
+    m_last_frame_us = m_time_us;
+
+    // in ticks * us, so the tick length doesn't have to be a whole us
+    constexpr u64 tick_length = 1000000;
+    m_tick_accumulator += frame_us * tick_rate;
+    u64 ticks = m_tick_accumulator / tick_length;
+    m_tick_accumulator -= ticks * tick_length;
+    m_sim_time_us += frame_us;
+    if (ticks > max_ticks_per_frame) { // drop the rest
+        m_sim_time_us -= (ticks - max_ticks_per_frame) * tick_length / tick_rate;
+        ticks = max_ticks_per_frame;
+    }
+    m_alpha = static_cast<float>(m_tick_accumulator) / tick_length;
+    return ticks;
 }
 
-void Game::handle_events()
+void Game::tick()
 {
-    for (const auto& event : events) {
-        switch (event.get_type()) {
-        case Event_type::word_input: {
-            on_word_input(event);
-            break;
-        }
-        case Event_type::word_missed: {
-            on_word_missed(event);
-            break;
+    hscroll_words.tick((float)m_width, [this](const Scroll_word_text& text) {
+        events.push_back(Event::create_word_missed(text.text));
+    });
+    // flashes that left the screen go back to the pool
+    hscroll_rects.release_if([this](H_scroll<Rect>& hscroll_rect) {
+        return tf::update(hscroll_rect, (float)m_width);
+    });
+}
+
+size_t Game::drain_keystrokes()
+{
+    if (m_replaying) { // the keyboard is ignored
+        Keystroke key;
+        while (m_keys.pop(key)) {}
+        return m_replay_key_count;
+    }
+
+    size_t key_count = 0;
+    while (key_count < Key_capture::capacity && m_keys.pop(m_keystrokes[key_count])) {
+        m_journal.keystroke(m_keystrokes[key_count]);
+        key_count++;
+    }
+    return key_count;
+}
+
+void Game::read_replay_frame()
+{
+    m_replay_key_count = 0;
+    m_replay_record_count = 0;
+    if (m_replay.peek() != Journal_record_type::frame) {
+        finish_replay();
+        return;
+    }
+
+    m_time_us = m_replay.next().time_us;
+    while (!m_replay.at_end() && m_replay.peek() != Journal_record_type::frame) {
+        const Journal_record record = m_replay.next();
+        if (record.type == Journal_record_type::keystroke) {
+            if (m_replay_key_count < Key_capture::capacity) {
+                m_keystrokes[m_replay_key_count++] = record.key;
+            }
         }
-        case Event_type::word_hit: {
-            printf("word hit event not handled\n");
-            break;
+        else if (record.type != Journal_record_type::none) {
+            // the writer never puts more in a frame, the journal is broken
+            if (m_replay_record_count == replay_records_capacity) {
+                m_replay.set_corrupt();
+                break;
+            }
+            m_replay_records[m_replay_record_count++] = record;
         }
-        case Event_type::first_letter_input: {
-            on_first_letter_input(event);
-            break;
+    }
+    // a broken frame is dropped, the score can't be verified
+    if (m_replay.is_corrupt()) {
+        m_replay_key_count = 0;
+        m_replay_record_count = 0;
+        finish_replay();
+    }
+}
+
+void Game::finish_replay()
+{
+    m_replaying = false;
+    if (m_replay.is_corrupt()) {
+        printf("replay stopped: journal is corrupt\n");
+    }
+    else {
+        printf("replay finished: wpm %.1f, adjusted wpm %.1f, edits %llu\n",
+               m_wpm_stats.get_wpm(), m_wpm_stats.get_adjusted_wpm(),
+               static_cast<unsigned long long>(m_wpm_stats.get_edit_count()));
+    }
+    m_time_us = m_input.time_us;
+    m_last_frame_us = 0;
+    m_latency.set_enabled(true);
+    reset_game();
+    if (m_close_after_replay) platform::request_close();
+}
+
+void Game::apply_replay_records(Journal_record_type type)
+{
+    for (size_t i = 0; i < m_replay_record_count; i++) {
+        const Journal_record& record = m_replay_records[i];
+        if (record.type != type) continue;
+        if (type == Journal_record_type::reset) {
+            reset_game(record.seed);
         }
+        else if (type == Journal_record_type::slider && record.index < sliders.size()) {
+            slider_set_value(sliders[record.index], record.value);
         }
     }
+}
+
+void Game::update_audio()
+{
+    music.update();
+}
 
+void Game::handle_events()
+{
+    m_event_bus.dispatch(events);
     events.clear();
 }
 
-void Game::on_word_input(const Event& event)
+void Game::on_event(const Event_word_input& event)
 {
-    const auto len = strlen(event.get_word_input()->word);
-    std::string typed{event.get_word_input()->word, len};
-    auto it = hscroll_words.find(typed);
-    if (it != hscroll_words.end()) { // entered correct word
-        hscroll_words.erase(it);
-        m_wpm_stats.word_input(len);
+    std::string typed{event.word};
+    if (m_fold_matching) {
+        char folded[Event_word_input::size];
+        fold_utf8(typed.c_str(), folded, Event_word_input::size);
+        typed = folded;
+    }
+    const u32 hit = hscroll_words.find(typed.c_str());
+    // hits carry the word as shown, the match key may be folded
+    if (hit != Scroll_words::npos) { // entered correct word
+        events.push_back(Event::create_word_hit(hscroll_words.text(hit).text, event.time_us));
+        hscroll_words.remove(hit);
+    }
+    else if (m_fuzzy_edits > 0) { // accept the closest word within the limit
+        m_fuzzy.set_pattern(typed.c_str());
+        u32 best = Scroll_words::npos;
+        int best_edits = m_fuzzy_edits + 1;
+        hscroll_words.for_each_text([&](u32 text_id, const Scroll_word_text& text) {
+            const int edits = m_fuzzy.distance(text.match_key, best_edits - 1);
+            if (edits < best_edits) {
+                best = text_id;
+                best_edits = edits;
+            }
+            return best_edits > 1;
+        });
+        if (best != Scroll_words::npos) {
+            const u32 index = hscroll_words.find_text(best);
+            events.push_back(Event::create_word_hit(hscroll_words.text(index).text,
+                                                    event.time_us, best_edits));
+            hscroll_words.remove(index);
+        }
     }
 }
 
-void Game::on_word_missed(const Event& event)
+void Game::on_event(const Event_word_missed& event)
 {
     constexpr float speed = 5;
     constexpr float size = 50;
     tf::Rect rect{{m_width - size, 0, size, (float)m_height},
                   tf::col_white, {0xFF,0,0,100}, 0};
-    bool found = false;
-    for (auto& hscroll_rect : hscroll_rects) {
-        if (!hscroll_rect.active) {
-            found = true;
-            hscroll_rect.active = true;
-            hscroll_rect.drawable = rect;
-        }
-    }
-    if (!found) {
-        hscroll_rects.push_back({
-                std::move(rect), speed, size, true,
-                [](tf::H_scroll<tf::Rect>* hscroll){
-                    hscroll->active = false;}}
-            );
-    }
+    hscroll_rects.acquire({
+            std::move(rect), speed, size, true,
+            [](tf::H_scroll<tf::Rect>* hscroll){
+                hscroll->active = false;}}
+        );
 }
 
-void Game::on_first_letter_input(const Event& event)
+void Game::on_timer(Game_timer timer, u64 deadline_us)
 {
-    m_wpm_stats.first_letter_input();
+    switch (timer) {
+    case Game_timer::spawn_word:
+        spawn_word(m_sim_time_us - deadline_us);
+        m_last_spawn_us = deadline_us;
+        m_spawn_timer = m_timers.schedule(deadline_us + spawn_period_us(),
+                                          Game_timer::spawn_word);
+        break;
+    case Game_timer::spawn_pause:
+        m_timers.cancel(m_spawn_timer);
+        break;
+    case Game_timer::apply_wpm:
+        if (m_timers.cancel(m_spawn_timer)) {
+            m_spawn_timer = m_timers.schedule(m_last_spawn_us + spawn_period_us(),
+                                              Game_timer::spawn_word);
+        }
+        break;
+    }
 }
 
-void Game::spawn_word()
+void Game::spawn_word(u64 late_us)
 {
     constexpr int top = 100;
     const int bot = m_height - 200;
@@ -293,67 +640,122 @@ void Game::spawn_word()
     std::uniform_real_distribution<float> speed_dist(0.2f, 0.7f);
     std::uniform_int_distribution<int> x_dist(-200, -100);
 
-    std::string str = m_wordgen.next();
     tf::Word word{"", tf::col_white, 30, {(float)x_dist(m_re), (float)y_dist(m_re)}};
-    strcpy_s(word.text, word.text_size, str.c_str());
-    H_scroll<Text_highlightable<Word>> obj = {
-        {std::move(word), tf::col_green, 0,
-         []() -> const char* {
-             return Game::instance().m_input_box.text_input.text.text; }
-        },
-        (float)speed_dist(m_re), 0, true,
-        [](tf::H_scroll<tf::Text_highlightable<tf::Word>>* hscroll) {
-            hscroll->active = false;
-        }
-    };
-    tf::H_scroll_set_width(&m_font, obj);
-    hscroll_words.insert({std::move(str), std::move(obj)});
+    if (m_chain_mode && m_chain_letter != 0) {
+        m_wordgen.next_starting_with(m_chain_letter, word.text, word.text_size);
+    }
+    else {
+        m_wordgen.next(word.text, word.text_size);
+    }
+    m_chain_letter = Word_generator::last_codepoint(word.text);
+    const float speed = speed_dist(m_re);
+    // the deadline is within the simulated time, so this stays within the
+    // frame's ticks but for rounding
+    const float late_ticks = std::min(late_us * tick_rate / 1000000.0f,
+                                      static_cast<float>(m_frame_ticks));
+    word.pos.x += speed * late_ticks;
+    hscroll_words.add(&m_font, word, tf::col_green, speed, m_fold_matching);
 }
 
+const char* Game::match_input() const
+{
+    return m_fold_matching ?
+        m_input_box.text_input.folded : m_input_box.text_input.text.text;
+}
 
-void Game::draw()
+
+void Game::draw(const Render_snapshot& snapshot)
 {
-    BeginDrawing();
+    platform::begin_frame();
 
     // ============================================================ //
     // Draw
     // ============================================================ //
-    ClearBackground(tf::col_cornflower_blue);
-    DrawFPS(5, 5);
+    platform::clear(tf::col_cornflower_blue);
+    platform::draw_fps(5, 5);
 
-    for (const auto& word : words) {
+    for (const auto& word : snapshot.words) {
         tf::draw(&m_font, word);
     }
-    for (const auto& text : texts) {
+    for (const auto& text : snapshot.texts) {
         tf::draw(&m_font, text);
     }
-    for (const auto& formatter : word_formatters) {
+    for (const auto& formatter : snapshot.word_formatters) {
         tf::draw(&m_font, formatter);
     }
-    for (const auto& map : hscroll_words) {
-        tf::draw(&m_font, map.second);
-    }
-    for (const auto& rect : rects) {
+    tf::draw(&m_font, snapshot.hscroll_words, snapshot.alpha);
+    for (const auto& rect : snapshot.rects) {
         tf::draw(&m_font, rect);
     }
-    for (const auto& button : buttons) {
+    for (const auto& button : snapshot.buttons) {
         tf::draw(&m_font, button);
     }
-    for (const auto& slider : sliders) {
+    for (const auto& slider : snapshot.sliders) {
         tf::draw(&m_font, slider);
     }
-    for (const auto& hscroll_rect : hscroll_rects) {
-        tf::draw(&m_font, hscroll_rect);
+    for (const auto& hscroll_rect : snapshot.hscroll_rects) {
+        tf::draw(&m_font, hscroll_rect, snapshot.alpha);
     }
-    tf::draw(&m_font, m_input_box);
+    tf::draw(&m_font, snapshot.input_box);
+    if (snapshot.show_latency) draw_latency_overlay(snapshot);
     // DrawTextureV(gnome, {100,100}, RAYWHITE);
 
-    EndDrawing();
+    m_limiter.work_done();
+    platform::end_frame();
+}
+
+void Game::draw_latency_overlay(const Render_snapshot& snapshot)
+{
+    // one column per ms, up to 50 ms
+    constexpr int columns = 50;
+    constexpr size_t buckets_per_column = 1000 / Latency_histogram::bucket_us;
+    constexpr int column_width = 4;
+    constexpr int height = 80;
+    const int x = m_width - columns * column_width - 10;
+    const int y = 40;
+
+    const Latency_histogram& histogram = m_latency.histogram(Latency_tracker::present);
+    u32 counts[columns] = {};
+    u32 max_count = 1;
+    for (int column = 0; column < columns; column++) {
+        for (size_t i = 0; i < buckets_per_column; i++) {
+            counts[column] += histogram.bucket(column * buckets_per_column + i);
+        }
+        if (counts[column] > max_count) max_count = counts[column];
+    }
+
+    platform::draw_rectangle({(float)x, (float)y, (float)(columns * column_width), (float)height},
+                             {0, 0, 0, 120});
+    for (int column = 0; column < columns; column++) {
+        const int bar = static_cast<int>(counts[column] * (u64)height / max_count);
+        platform::draw_rectangle({(float)(x + column * column_width), (float)(y + height - bar),
+                                  (float)(column_width - 1), (float)bar}, tf::col_orange);
+    }
+
+    char text[64];
+    sprintf_s(text, sizeof(text), "p50 %.1f p99 %.1f max %.1f ms",
+              histogram.percentile_us(0.5) / 1000.0,
+              histogram.percentile_us(0.99) / 1000.0, histogram.max_us() / 1000.0);
+    platform::draw_text(m_font, text, {(float)x, (float)(y + height + 2)}, 16, 0, tf::col_white);
+
+    const Frame_stats frames = m_limiter.stats();
+    sprintf_s(text, sizeof(text), "frame %.2f+-%.2f jitter p99 %.1f ms%s",
+              frames.mean_us / 1000.0, frames.stddev_us / 1000.0,
+              frames.jitter_p99_us / 1000.0, m_limiter.latency_mode() ? " (F5 low lat)" : "");
+    platform::draw_text(m_font, text, {(float)x, (float)(y + height + 20)}, 16, 0, tf::col_white);
+
+    // a dropped event is a lost hit or miss, so make them hard to overlook
+    sprintf_s(text, sizeof(text), "events max %llu/%llu dropped %llu",
+              static_cast<unsigned long long>(snapshot.events_high_water),
+              static_cast<unsigned long long>(Frame_events::capacity()),
+              static_cast<unsigned long long>(snapshot.events_dropped));
+    platform::draw_text(m_font, text, {(float)x, (float)(y + height + 38)}, 16, 0,
+                        snapshot.events_dropped > 0 ? tf::col_red : tf::col_white);
 }
 
 void Game::load_word_generator(const char* wordfile)
 {
-    dutil::Stopwatch sw{};
+    Stopwatch sw{};
     sw.start();
     tf::File file{wordfile};
     if (file.has_error()) {
@@ -362,20 +764,63 @@ void Game::load_word_generator(const char* wordfile)
     }
     sw.stop();
     printf("load file: %.2f ms\n", sw.fnow_ms());
-    printf("file size: %llu\n", file.get_size());
+    printf("file size: %llu\n", (unsigned long long)file.get_size());
+
+    m_dictionary_id = dictionary_id(file.get(), file.get_size());
 
     sw.start();
     DelimSettings settings{ true, false, false, false, false };
     m_wordgen.load(file, settings);
     sw.stop();
     printf("init wordgen: %.2f ms\n", sw.fnow_ms());
-    printf("Words loaded: %llu.\n", m_wordgen.word_count());
+    printf("Words loaded: %llu.\n", (unsigned long long)m_wordgen.word_count());
 }
 
 void Game::reset_game()
+{
+    reset_game(static_cast<u32>(m_rd()));
+}
+
+void Game::reset_game(u32 seed)
 {
     hscroll_words.clear();
-    m_wpm_stats.reset();
+    m_wpm_stats.reset(m_time_us);
+    // the wheel starts over, so simulated time can catch up with game time
+    m_sim_time_us = m_time_us;
+    m_timers.reset(m_sim_time_us);
+    m_spawn_timer = m_timers.schedule(m_sim_time_us, Game_timer::spawn_word);
+    m_spawn_pause_timer = m_timers.schedule(m_sim_time_us + spawn_idle_after_us,
+                                            Game_timer::spawn_pause);
+    m_apply_wpm_timer = {};
+    m_chain_letter = 0;
+    m_re.seed(seed);
+    m_wordgen.seed(seed);
+    m_journal.reset(seed);
+}
+
+bool Game::record(const char* path)
+{
+    m_time_us = platform::time_us();
+    if (!m_journal.open(path, {m_dictionary_id, m_time_us})) return false;
+    reset_game();
+    return true;
+}
+
+bool Game::replay(const char* path)
+{
+    m_journal.close();
+    if (!m_replay.open(path)) return false;
+    if (m_replay.header().dictionary_id != m_dictionary_id) {
+        printf("%s was recorded with another dictionary\n", path);
+        return false;
+    }
+    m_replaying = true;
+    m_latency.set_enabled(false);
+    m_time_us = m_replay.header().start_time_us;
+    while (m_replay.peek() == Journal_record_type::reset) {
+        reset_game(m_replay.next().seed);
+    }
+    return true;
 }
 
 }
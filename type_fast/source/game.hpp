@@ -33,18 +33,33 @@
 #include <vector>
 #include <random>
 #include <unordered_map>
-#include "event.hpp"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "event_buffer.hpp"
+#include "event_bus.hpp"
+#include "render_snapshot.hpp"
 #include "audio/tfmusic.hpp"
 #include "audio/tfsound.hpp"
 #include "thirdparty/filip/unicode.h"
-#include "thirdparty/dutil/stopwatch.hpp"
 #include "util/color.hpp"
 #include "util/util.hpp"
 #include "util/file.hpp"
 #include "util/word_generator.hpp"
-#include "util/raylib_lifetime.hpp"
+#include "util/fuzzy_match.hpp"
+#include "util/fold.hpp"
+#include "util/key_capture.hpp"
+#include "util/journal.hpp"
+#include "util/latency.hpp"
+#include "util/frame_pacer.hpp"
+#include "util/frame_limiter.hpp"
+#include "util/timing_wheel.hpp"
+#include "util/object_pool.hpp"
+#include "util/clock.hpp"
+#include "platform/platform.hpp"
 #include "widget/wpm.hpp"
 #include "widget/widget.hpp"
+#include "widget/scroll_words.hpp"
 
 // ============================================================ //
 // Class
@@ -53,13 +68,25 @@
 namespace tf
 {
 
+/**
+ * What a timer in Game::m_timers does when it fires.
+ */
+enum class Game_timer : u8
+{
+    spawn_word,
+    // stop spawning, nobody is typing
+    spawn_pause,
+    // the wpm slider settled, respawn at the new rate
+    apply_wpm,
+};
+
 class Game
 {
     // ============================================================ //
-    // OpenGL context lifetime
+    // Platform lifetime
     // ============================================================ //
     // must be first
-    Raylib_lifetime raylib_lifetime{};
+    Platform_lifetime platform_lifetime{};
 
 private:
 
@@ -82,11 +109,26 @@ public:
      */
     void run();
 
+    /**
+     * Simulate the next frame on its own thread while this one is drawn.
+     * Adds a frame of latency, but update time no longer adds to frame time.
+     * Call before run.
+     */
+    void set_pipelined(bool pipelined) { m_pipelined = pipelined; }
+
+    /**
+     * Start frames late so they are done just before the vertical blank and
+     * input is sampled as late as possible, F5 toggles it while running.
+     * Needs vsync.
+     */
+    void set_latency_mode(bool latency_mode) { m_limiter.set_latency_mode(latency_mode); }
+
     // ============================================================ //
     // Setup
     // ============================================================ //
     /**
      * Call once before doing anything else.
+     * @param target_fps 0 runs as fast as it can.
      */
     void setup(int width, int height, const char* title, int target_fps,
                       const char* font, const char* text_file);
@@ -96,37 +138,189 @@ public:
     // ============================================================ //
     // Update
     // ============================================================ //
+    /**
+     * Read the platform input for this frame into m_input, main thread only.
+     */
+    void sample_input();
+
     void update();
 
+    /**
+     * Copy what draw needs into @snapshot.
+     */
+    void take_snapshot(Render_snapshot& snapshot);
+
+    /**
+     * Simulation thread of the pipelined main loop.
+     */
+    void run_simulation();
+
     void update_game_objects();
 
     void update_audio();
 
     /**
+     * Dispatch this frame's events to the subscribers, then clear them.
      * Unhandled events will be destroyed.
      */
     void handle_events();
 
-    void on_word_input(const Event& event);
+    /**
+     * @param late_us How long ago the word should have spawned, it is moved
+     * as far as it would have come since.
+     */
+    void spawn_word(u64 late_us = 0);
+
+    /**
+     * Fire the timers due this frame.
+     */
+    void on_timer(Game_timer timer, u64 deadline_us);
+
+    u64 spawn_period_us() const { return 60000000 / static_cast<u64>(m_wpm); }
+
+    /**
+     * Feed the time since the last frame to the tick accumulator and
+     * advance m_sim_time_us by the time those ticks cover.
+     * @return How many ticks to simulate this frame.
+     */
+    u64 advance_ticks();
 
-    void on_word_missed(const Event& event);
+    /**
+     * Advance the simulation by one fixed tick, 1/tick_rate seconds.
+     */
+    void tick();
 
-    void on_first_letter_input(const Event& event);
+    /**
+     * Move this frame's keystrokes into m_keystrokes, from the keyboard or
+     * the replay, and record them.
+     * @return How many keystrokes there are.
+     */
+    size_t drain_keystrokes();
 
-    void spawn_word();
+    /**
+     * Read the next frame from the replay, sets the game time and stages its
+     * keystrokes and other records.
+     */
+    void read_replay_frame();
+
+    /**
+     * Print the replayed score, or that the journal was corrupt, and go back
+     * to live input.
+     */
+    void finish_replay();
+
+    /**
+     * Apply the staged replay records of @type, in the order they were
+     * recorded.
+     */
+    void apply_replay_records(Journal_record_type type);
 
     // ============================================================ //
     // Draw
     // ============================================================ //
-    void draw();
+    void draw(const Render_snapshot& snapshot);
+
+    /**
+     * Histogram of the keystroke to present latency, toggled with F3, with
+     * the frame times and how full the event buffer got.
+     */
+    void draw_latency_overlay(const Render_snapshot& snapshot);
+
+    /**
+     * Record the present latency of the keys in @snapshot.
+     */
+    void presented(const Render_snapshot& snapshot, u64 time_us);
+
+    /**
+     * Set the frame rate for the next frame from how idle the game is, main
+     * thread only.
+     */
+    void pace();
 
     // ============================================================ //
     // Modifiers
     // ============================================================ //
     void load_word_generator(const char* wordfile);
 
+    /**
+     * Start over with a new seed.
+     */
     void reset_game();
 
+    /**
+     * Start over, the same @seed gives the same words.
+     */
+    void reset_game(u32 seed);
+
+    /**
+     * Record the inputs of the session to @path, call after setup.
+     * @return If the journal could be created.
+     */
+    bool record(const char* path);
+
+    /**
+     * Feed the inputs recorded in @path back through update instead of the
+     * keyboard and mouse. Call after setup. When the journal ends, the score
+     * is printed and the game starts over with live input.
+     * @return If the journal could be read and matches the dictionary.
+     */
+    bool replay(const char* path);
+
+    /**
+     * Make the main loop stop once a replay ends, instead of continuing with
+     * live input.
+     */
+    void set_close_after_replay(bool close) { m_close_after_replay = close; }
+
+    /**
+     * Spawn pseudo-words made only from @letters instead of dictionary words,
+     * see Word_generator::set_letter_drill.
+     * @return If the drill could be started.
+     */
+    bool set_letter_drill(const char* letters)
+        { return m_wordgen.set_letter_drill(letters, drill_min_length, drill_max_length); }
+
+    /**
+     * Cost words for typing on @layout, the difficulty slider picks from
+     * them by that cost.
+     */
+    void set_layout(Keyboard_layout layout) { m_wordgen.set_layout(layout); }
+
+    /**
+     * In chain mode, each spawned word begins with the last letter of the
+     * previous one.
+     */
+    void set_chain_mode(bool chain_mode) { m_chain_mode = chain_mode; }
+
+    /**
+     * Accept entered words that are up to @max_edits typos away from an
+     * active word, 0 to only accept exact words.
+     */
+    void set_fuzzy_edits(int max_edits) { m_fuzzy_edits = max_edits > 0 ? max_edits : 0; }
+
+    /**
+     * Match input against words ignoring case and diacritics, so "e" will
+     * match "É". The words on screen are matched the new way as well.
+     */
+    void set_fold_matching(bool fold)
+        {
+            if (fold == m_fold_matching) return;
+            m_fold_matching = fold;
+            hscroll_words.set_fold(fold);
+            m_input_box.text_input.version++; // match_input changed
+        }
+
+    /**
+     * The input text that words are matched against, folded or not.
+     */
+    const char* match_input() const;
+
+    // ============================================================ //
+    // Events
+    // ============================================================ //
+    void on_event(const Event_word_input& event);
+    void on_event(const Event_word_missed& event);
+
     // ============================================================ //
     // Lookup
     // ============================================================ //
@@ -149,20 +343,104 @@ private:
     int m_height = 0;
     Font m_font;
     Word_generator m_wordgen{};
+    // in codepoints, of letter drill words
+    static constexpr int drill_min_length = 3;
+    static constexpr int drill_max_length = 7;
     std::random_device m_rd{};
     std::default_random_engine m_re{m_rd()};
 
     // how fast words will be created
-    double m_wpm_timer = 0;
     int m_wpm = 0;
 
+    // timed game actions, in simulated time so spawning keeps pace with the
+    // ticks that moved the words, and replays fire them the same way
+    Timing_wheel<Game_timer> m_timers{};
+    Timer_handle m_spawn_timer{};
+    u64 m_last_spawn_us = 0;
+    // without a keystroke for this long no more words spawn, so the game
+    // can go idle once the last word has left the screen
+    static constexpr u64 spawn_idle_after_us = 60000000;
+    Timer_handle m_spawn_pause_timer{};
+    // dragging the wpm slider only changes the spawn time once it settles
+    static constexpr u64 wpm_debounce_us = 150000;
+    Timer_handle m_apply_wpm_timer{};
+
+    // game time, when the frame began or when the replayed frame began
+    u64 m_time_us = 0;
+
+    // fixed simulation tick, scrolling speeds are in pixels per tick
+    static constexpr u64 tick_rate = 144;
+    // after a long stall the game slows down instead of catching up
+    static constexpr u64 max_ticks_per_frame = 8;
+    u64 m_last_frame_us = 0;
+    // game time minus what stalls dropped, the timers run on it
+    u64 m_sim_time_us = 0;
+    // in tick * us, see advance_ticks
+    u64 m_tick_accumulator = 0;
+    // how far into the next tick we are, 0-1
+    float m_alpha = 1.0f;
+    // ticks simulated this frame
+    u64 m_frame_ticks = 0;
+
+    // record or replay the session
+    u64 m_dictionary_id = 0;
+    Journal_writer m_journal{};
+    Journal_reader m_replay{};
+    bool m_replaying = false;
+    bool m_close_after_replay = false;
+    // records of the replayed frame besides keystrokes
+    static constexpr size_t replay_records_capacity = 8;
+    Journal_record m_replay_records[replay_records_capacity];
+    size_t m_replay_record_count = 0;
+    size_t m_replay_key_count = 0;
+
+    // word chain mode, next word begins with m_chain_letter
+    bool m_chain_mode = false;
+    u32 m_chain_letter = 0;
+
+    // case and diacritic insensitive matching
+    bool m_fold_matching = false;
+
+    // fuzzy word matching, 0 is off
+    int m_fuzzy_edits = 0;
+    Fuzzy_matcher m_fuzzy{};
+
     // track time spent in update
-    dutil::Stopwatch updatetime{};
+    Stopwatch updatetime{};
     double updatetime_last = 0;
 
+    Frame_input m_input{};
+
+    // pipelined main loop, the simulation writes m_snapshots[m_back] while
+    // the main thread draws the other one
+    bool m_pipelined = true;
+    Render_snapshot m_snapshots[2];
+    int m_back = 0;
+    std::thread m_simulation{};
+    std::mutex m_simulation_mutex{};
+    std::condition_variable m_simulation_cv{};
+    bool m_simulate = false;
+    bool m_simulation_quit = false;
+
     // track the players wpm
     Wpm m_wpm_stats{};
 
+    // keystroke to screen latency, F4 exports it to latency_file
+    Latency_tracker m_latency{};
+    bool m_show_latency = false;
+    static constexpr const char* latency_file = "latency.csv";
+
+    // timestamped keystrokes, drained into m_keystrokes every update
+    Key_capture m_keys{};
+
+    // lowers the frame rate while nothing moves, see pace
+    Frame_pacer m_pacer{};
+    // waits for the next frame, main thread only
+    Frame_limiter m_limiter{};
+    // if anything moved in the last update
+    bool m_animating = true;
+    Keystroke m_keystrokes[Key_capture::capacity];
+
     // ============================================================ //
     // Game Objects
     // ============================================================ //
@@ -170,14 +448,17 @@ private:
     std::vector<Word> words;
     std::vector<Text> texts;
     std::vector<Word_formatter> word_formatters;
-    std::unordered_map<std::string, H_scroll<Text_highlightable<Word>>> hscroll_words;
+    Scroll_words hscroll_words;
     std::vector<Rect> rects;
     std::vector<Button<Word>> buttons;
     std::vector<Slider> sliders;
-    std::vector<H_scroll<Rect>> hscroll_rects;
+    // miss flashes
+    Object_pool<H_scroll<Rect>> hscroll_rects;
     Tfmusic music{};
     std::vector<Tfsound> sounds;
-    std::vector<Event> events;
+    Frame_events events{};
+    // must be after its subscribers
+    Event_bus<Game, Wpm> m_event_bus{*this, m_wpm_stats};
 };
 
 }
@@ -26,26 +26,114 @@
 // Headers
 // ============================================================ //
 
+#include <cstring>
+#include <cstdlib>
 #include "game.hpp"
+#ifdef _WIN32
 #include "util/win.hpp"
+#endif
 
 // ============================================================ //
 // Main
 // ============================================================ //
 
-int main(int, char**)
+int main(int argc, char** argv)
 {
+#ifdef _WIN32
     tf::fix_console(); // make it use UTF8
+#endif
 
     //constexpr int width = 1280;
     constexpr int width = 1000;
     constexpr int height = 720;
+#ifndef TF_HEADLESS
     constexpr int target_fps = 144;
+#else
+    constexpr int target_fps = 0; // frames are simulated, don't wait for them
+#endif
     const char* font = "res/fonts/open-sans/OpenSans-Regular.ttf";
     const char* text_file = "res/dict/mobydick.txt";
+
+    // --replay <journal> plays back a session, else it's recorded
+    // --frames <n> headless only, stop after n frames
+    // --pipelined <0|1> simulate the next frame while drawing, default 1
+    // --latency-mode <0|1> sample input as late as possible, default 0
+    // --drill <letters> spawn pseudo-words made only from these letters
+    // --layout <qwerty|dvorak|colemak> keyboard the difficulty is for
+    // --chain <0|1> each word begins with the last letter of the one before
+    // --fuzzy <n> accept words up to n typos away, default 0
+    // --fold <0|1> match ignoring case and diacritics, default 0
+    const char* replay_file = nullptr;
+    unsigned long long frames = 0;
+    bool pipelined = true;
+    bool latency_mode = false;
+    const char* drill_letters = nullptr;
+    const char* layout_name = nullptr;
+    bool chain_mode = false;
+    int fuzzy_edits = 0;
+    bool fold_matching = false;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--replay") == 0) replay_file = argv[i + 1];
+        else if (strcmp(argv[i], "--frames") == 0) frames = strtoull(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "--pipelined") == 0) pipelined = strcmp(argv[i + 1], "0") != 0;
+        else if (strcmp(argv[i], "--latency-mode") == 0) latency_mode = strcmp(argv[i + 1], "0") != 0;
+        else if (strcmp(argv[i], "--drill") == 0) drill_letters = argv[i + 1];
+        else if (strcmp(argv[i], "--layout") == 0) layout_name = argv[i + 1];
+        else if (strcmp(argv[i], "--chain") == 0) chain_mode = strcmp(argv[i + 1], "0") != 0;
+        else if (strcmp(argv[i], "--fuzzy") == 0) fuzzy_edits = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--fold") == 0) fold_matching = strcmp(argv[i + 1], "0") != 0;
+    }
+
     tf::Game& game = tf::Game::instance();
     game.setup(width, height, "Type Fast", target_fps, font, text_file);
+    game.set_pipelined(pipelined);
+    game.set_latency_mode(latency_mode);
+    game.set_chain_mode(chain_mode);
+    game.set_fuzzy_edits(fuzzy_edits);
+    game.set_fold_matching(fold_matching);
+    if (layout_name) {
+        tf::Keyboard_layout layout;
+        if (tf::keyboard_layout_from_string(layout_name, layout)) game.set_layout(layout);
+        else printf("unknown layout %s, using %s\n", layout_name,
+                    tf::keyboard_layout_to_string(tf::Keyboard_layout::qwerty));
+    }
+    if (drill_letters && !game.set_letter_drill(drill_letters)) {
+        printf("no words can be made from %s, using the dictionary\n", drill_letters);
+    }
+
+    if (replay_file) {
+        if (!game.replay(replay_file)) {
+            printf("could not replay %s\n", replay_file);
+            return 1;
+        }
+    }
+#ifndef TF_HEADLESS
+    const char* journal_file = "last_session.tfj";
+    if (!replay_file && !game.record(journal_file)) {
+        printf("could not record to %s\n", journal_file);
+    }
+    (void)frames;
+    game.run();
+#else
+    if (!replay_file) {
+        if (frames == 0) {
+            printf("headless needs --replay <journal> or --frames <n>\n");
+            return 1;
+        }
+        game.reset_game(0);
+    }
+
+    game.set_close_after_replay(true);
+    tf::platform::headless_set_frame_limit(frames);
+    tf::Stopwatch sw{};
+    sw.start();
     game.run();
+    sw.stop();
+    const auto stats = tf::platform::headless_stats();
+    printf("%llu frames in %.1f ms, %.0f frames/s, %llu draw calls\n",
+           (unsigned long long)stats.frames, sw.fms(), stats.frames / (sw.fms() / 1000.0),
+           (unsigned long long)stats.draw_calls);
+#endif
 
     return 0;
 }
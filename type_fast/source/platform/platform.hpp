@@ -0,0 +1,205 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __PLATFORM_HPP__
+#define __PLATFORM_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+// only for the plain data types and key codes, the functions are not called
+// outside the raylib backend
+#include <raylib.h>
+#include "../util/types.hpp"
+
+// ============================================================ //
+// Functions
+// ============================================================ //
+
+/**
+ * Everything the game needs from the outside world: the window, time, input,
+ * text measurement, drawing and audio. There are two backends, chosen at
+ * compile time:
+ *
+ * platform_raylib.cpp  - a window through raylib.
+ * platform_headless.cpp - no window, input or audio, draws are only counted
+ *                          and time advances a fixed step per frame. Build
+ *                          with TF_HEADLESS.
+ */
+namespace tf::platform
+{
+
+// ============================================================ //
+// Lifetime
+// ============================================================ //
+void init(int width, int height, const char* title);
+void shutdown();
+
+// ============================================================ //
+// Window
+// ============================================================ //
+bool should_close();
+void set_window_size(int width, int height);
+void set_window_title(const char* title);
+void toggle_fullscreen();
+void set_target_fps(int fps);
+
+/**
+ * @return If end_frame waits for the vertical blank.
+ */
+bool vsync();
+
+// ============================================================ //
+// Time
+// ============================================================ //
+/**
+ * Microseconds, on the same clock as now_us with a window.
+ */
+u64 time_us();
+
+/**
+ * Seconds the last frame took.
+ */
+float frame_time();
+
+// ============================================================ //
+// Input
+// ============================================================ //
+bool is_key_pressed(int key);
+
+/**
+ * Codepoint of the latest character typed, 0 if none.
+ */
+int get_key_pressed();
+
+bool is_mouse_pressed(int button);
+bool is_mouse_down(int button);
+Vector2 mouse_position();
+
+// ============================================================ //
+// Text
+// ============================================================ //
+Font load_font(const char* path, int size);
+void unload_font(Font font);
+
+/**
+ * @param text Null terminated UTF-8 string.
+ */
+Vector2 measure_text(const Font& font, const char* text, float font_size,
+                     float spacing);
+
+// ============================================================ //
+// Draw
+// ============================================================ //
+void begin_frame();
+
+/**
+ * Present the frame, waits for the target fps.
+ */
+void end_frame();
+
+void clear(Color color);
+void draw_text(const Font& font, const char* text, Vector2 pos, float font_size,
+               float spacing, Color color);
+void draw_rectangle(Rectangle rect, Color color);
+void draw_rectangle_lines(Rectangle rect, int thickness, Color color);
+void draw_line(Vector2 from, Vector2 to, Color color);
+void draw_fps(int x, int y);
+
+// ============================================================ //
+// Audio
+// ============================================================ //
+Music load_music(const char* path);
+void unload_music(Music music);
+void update_music(Music music);
+void play_music(Music music);
+void pause_music(Music music);
+void resume_music(Music music);
+void stop_music(Music music);
+void set_music_volume(Music music, float volume);
+bool is_music_playing(Music music);
+
+Sound load_sound(const char* path);
+void unload_sound(Sound sound);
+void play_sound(Sound sound);
+void pause_sound(Sound sound);
+void resume_sound(Sound sound);
+void stop_sound(Sound sound);
+bool is_sound_playing(Sound sound);
+
+// ============================================================ //
+// Headless
+// ============================================================ //
+#ifdef TF_HEADLESS
+/**
+ * How far time moves each frame.
+ */
+void headless_set_frame_step_us(u64 step_us);
+
+/**
+ * should_close() returns true after @frames frames, 0 runs until
+ * request_close().
+ */
+void headless_set_frame_limit(u64 frames);
+
+struct Headless_stats
+{
+    u64 frames;
+    u64 draw_calls;
+};
+
+Headless_stats headless_stats();
+#endif
+
+/**
+ * Make should_close() return true.
+ */
+void request_close();
+
+}
+
+// ============================================================ //
+// Class
+// ============================================================ //
+
+namespace tf
+{
+
+/**
+ * Opens and closes the platform, make it the first member of its owner.
+ */
+class Platform_lifetime
+{
+public:
+    Platform_lifetime() { platform::init(1280, 720, "Type Fast"); }
+    ~Platform_lifetime() { platform::shutdown(); }
+
+    Platform_lifetime(const Platform_lifetime& other) = delete;
+    Platform_lifetime& operator=(const Platform_lifetime& other) = delete;
+};
+
+}
+
+#endif//__PLATFORM_HPP__
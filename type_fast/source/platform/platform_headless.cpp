@@ -0,0 +1,131 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef TF_HEADLESS
+
+#include "platform.hpp"
+
+#include <atomic>
+
+#include "../thirdparty/filip/unicode.h"
+
+namespace tf::platform
+{
+
+// starts at an arbitrary time, so 0 is never a valid time
+static u64 s_time_us = 1000000;
+static u64 s_frame_step_us = 1000000 / 144;
+static u64 s_frame_limit = 0;
+// set by the simulation thread when a replay finishes
+static std::atomic<bool> s_close_requested{false};
+static Headless_stats s_stats{};
+
+void init(int, int, const char*) {}
+void shutdown() {}
+
+bool should_close()
+{
+    return s_close_requested || (s_frame_limit != 0 && s_stats.frames >= s_frame_limit);
+}
+
+void request_close() { s_close_requested = true; }
+void set_window_size(int, int) {}
+void set_window_title(const char*) {}
+void toggle_fullscreen() {}
+void set_target_fps(int) {}
+bool vsync() { return false; }
+
+u64 time_us() { return s_time_us; }
+float frame_time() { return s_frame_step_us / 1000000.0f; }
+
+void headless_set_frame_step_us(u64 step_us) { s_frame_step_us = step_us; }
+void headless_set_frame_limit(u64 frames) { s_frame_limit = frames; }
+Headless_stats headless_stats() { return s_stats; }
+
+bool is_key_pressed(int) { return false; }
+int get_key_pressed() { return 0; }
+bool is_mouse_pressed(int) { return false; }
+bool is_mouse_down(int) { return false; }
+Vector2 mouse_position() { return {-1.0f, -1.0f}; }
+
+Font load_font(const char*, int size)
+{
+    Font font{};
+    font.baseSize = size;
+    return font;
+}
+
+void unload_font(Font) {}
+
+/**
+ * No glyphs, every codepoint is half as wide as the font is tall.
+ */
+Vector2 measure_text(const Font&, const char* text, float font_size, float spacing)
+{
+    const u64 length = lnUTF8StringLength(text);
+    const float width = length > 0 ? length * (font_size / 2 + spacing) - spacing : 0;
+    return {width, font_size};
+}
+
+void begin_frame() {}
+
+void end_frame()
+{
+    s_stats.frames++;
+    s_time_us += s_frame_step_us;
+}
+
+void clear(Color) { s_stats.draw_calls++; }
+
+void draw_text(const Font&, const char*, Vector2, float, float, Color)
+{
+    s_stats.draw_calls++;
+}
+
+void draw_rectangle(Rectangle, Color) { s_stats.draw_calls++; }
+void draw_rectangle_lines(Rectangle, int, Color) { s_stats.draw_calls++; }
+void draw_line(Vector2, Vector2, Color) { s_stats.draw_calls++; }
+void draw_fps(int, int) { s_stats.draw_calls++; }
+
+Music load_music(const char*) { return nullptr; }
+void unload_music(Music) {}
+void update_music(Music) {}
+void play_music(Music) {}
+void pause_music(Music) {}
+void resume_music(Music) {}
+void stop_music(Music) {}
+void set_music_volume(Music, float) {}
+bool is_music_playing(Music) { return false; }
+
+Sound load_sound(const char*) { return Sound{}; }
+void unload_sound(Sound) {}
+void play_sound(Sound) {}
+void pause_sound(Sound) {}
+void resume_sound(Sound) {}
+void stop_sound(Sound) {}
+bool is_sound_playing(Sound) { return false; }
+
+}
+
+#endif
@@ -0,0 +1,125 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TF_HEADLESS
+
+#include "platform.hpp"
+
+#include <atomic>
+
+#include "../util/clock.hpp"
+
+namespace tf::platform
+{
+
+// set by the simulation thread when a replay finishes
+static std::atomic<bool> s_close_requested{false};
+
+void init(int width, int height, const char* title)
+{
+    // frames are paced by Frame_limiter, vsync lets it find the vertical blank
+    SetConfigFlags(FLAG_VSYNC_HINT);
+    InitWindow(width, height, title);
+    InitAudioDevice();
+}
+
+void shutdown()
+{
+    CloseWindow();
+
+    CloseAudioDevice();
+}
+
+bool should_close() { return s_close_requested || WindowShouldClose(); }
+void request_close() { s_close_requested = true; }
+void set_window_size(int width, int height) { SetWindowSize(width, height); }
+void set_window_title(const char* title) { SetWindowTitle(title); }
+void toggle_fullscreen() { ToggleFullscreen(); }
+void set_target_fps(int fps) { SetTargetFPS(fps); }
+bool vsync() { return true; }
+
+u64 time_us() { return now_us(); }
+float frame_time() { return GetFrameTime(); }
+
+bool is_key_pressed(int key) { return IsKeyPressed(key); }
+int get_key_pressed() { return GetKeyPressed(); }
+bool is_mouse_pressed(int button) { return IsMouseButtonPressed(button); }
+bool is_mouse_down(int button) { return IsMouseButtonDown(button); }
+Vector2 mouse_position() { return GetMousePosition(); }
+
+Font load_font(const char* path, int size)
+{
+    Font font = LoadFontEx(path, size, 224, NULL);
+    SetTextureFilter(font.texture, FILTER_BILINEAR);
+    return font;
+}
+
+void unload_font(Font font) { UnloadFont(font); }
+
+Vector2 measure_text(const Font& font, const char* text, float font_size, float spacing)
+{
+    return MeasureTextEx(font, text, font_size, spacing);
+}
+
+void begin_frame() { BeginDrawing(); }
+void end_frame() { EndDrawing(); }
+void clear(Color color) { ClearBackground(color); }
+
+void draw_text(const Font& font, const char* text, Vector2 pos, float font_size,
+               float spacing, Color color)
+{
+    DrawTextEx(font, text, pos, font_size, spacing, color);
+}
+
+void draw_rectangle(Rectangle rect, Color color) { DrawRectangleRec(rect, color); }
+
+void draw_rectangle_lines(Rectangle rect, int thickness, Color color)
+{
+    DrawRectangleLinesEx(rect, thickness, color);
+}
+
+void draw_line(Vector2 from, Vector2 to, Color color) { DrawLineV(from, to, color); }
+void draw_fps(int x, int y) { DrawFPS(x, y); }
+
+Music load_music(const char* path) { return LoadMusicStream(path); }
+void unload_music(Music music) { UnloadMusicStream(music); }
+void update_music(Music music) { UpdateMusicStream(music); }
+void play_music(Music music) { PlayMusicStream(music); }
+void pause_music(Music music) { PauseMusicStream(music); }
+void resume_music(Music music) { ResumeMusicStream(music); }
+void stop_music(Music music) { StopMusicStream(music); }
+void set_music_volume(Music music, float volume) { SetMusicVolume(music, volume); }
+bool is_music_playing(Music music) { return IsMusicPlaying(music); }
+
+Sound load_sound(const char* path) { return LoadSound(path); }
+void unload_sound(Sound sound) { UnloadSound(sound); }
+void play_sound(Sound sound) { PlaySound(sound); }
+void pause_sound(Sound sound) { PauseSound(sound); }
+void resume_sound(Sound sound) { ResumeSound(sound); }
+void stop_sound(Sound sound) { StopSound(sound); }
+bool is_sound_playing(Sound sound) { return IsSoundPlaying(sound); }
+
+}
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __RENDER_SNAPSHOT_HPP__
+#define __RENDER_SNAPSHOT_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <vector>
+#include "widget/widget.hpp"
+#include "widget/scroll_words.hpp"
+#include "util/key_capture.hpp"
+#include "util/types.hpp"
+
+// ============================================================ //
+// Struct
+// ============================================================ //
+
+namespace tf
+{
+
+/**
+ * Everything needed to draw one frame, copied out of the game after it
+ * updated. The render thread only reads snapshots, so the next frame can be
+ * simulated while this one is drawn. The vectors keep their capacity between
+ * frames, so taking a snapshot doesn't allocate once the game has warmed up.
+ */
+struct Render_snapshot
+{
+    std::vector<Word> words;
+    std::vector<Text> texts;
+    std::vector<Word_formatter> word_formatters;
+    Scroll_word_arrays hscroll_words;
+    std::vector<Rect> rects;
+    std::vector<Button<Word>> buttons;
+    std::vector<Slider> sliders;
+    std::vector<H_scroll<Rect>> hscroll_rects;
+    Input_box<Text_input<Word>> input_box;
+    // how far into the next tick the frame is, see Game::advance_ticks
+    float alpha;
+    bool show_latency;
+    // see Event_buffer::high_water and overflow_count
+    size_t events_high_water;
+    u64 events_dropped;
+    // capture times of the keystrokes handled this frame
+    u64 capture_us[Key_capture::capacity];
+    size_t key_count;
+};
+
+/**
+ * Input sampled on the main thread at the start of a frame, the update only
+ * reads this instead of asking the platform.
+ */
+struct Frame_input
+{
+    u64 time_us;
+    float frame_time;
+    Mouse_state mouse;
+    bool toggle_latency;
+    bool export_latency;
+};
+
+}
+
+#endif//__RENDER_SNAPSHOT_HPP__
@@ -418,6 +418,55 @@ char8* lnUTF8SubstringFrom(const char8* string, u64 from)
 
 // -------------------------------------------------------------------------- //
 
+LnUTF8Span lnUTF8Subspan(const char8* string, u64 from, u64 count)
+{
+	// Return empty span if string is NULL
+	LnUTF8Span span = { string, 0 };
+	if (!string) { return span; }
+
+	// Offset and bytecount
+	u64 offset = 0;
+	u32 bytecount;
+
+	// Iterate through string until the end of the substring
+	u64 _codepoint;
+	u64 index = 0;
+	while (string[offset] != 0 && index < from + count)
+	{
+		if (index == from) { span.data = string + offset; }
+
+		// Decode the next byte(s)
+		const bool _valid = lnUTF8Decode(string, offset, &_codepoint, &bytecount);
+		if (!_valid) { break; }
+
+		// Increment offset and bytecount
+		offset += bytecount;
+		index++;
+	}
+
+	// Clamp start to the end of the string
+	if (index <= from) { span.data = string + offset; }
+
+	span.size = (u64)((string + offset) - span.data);
+	return span;
+}
+
+// -------------------------------------------------------------------------- //
+
+LnUTF8Span lnUTF8SubspanFrom(const char8* string, u64 from)
+{
+	// Return empty span if string is NULL
+	LnUTF8Span span = { string, 0 };
+	if (!string) { return span; }
+
+	// Find start of the substring
+	span.data = string + lnUTF8OffsetOfIndex(string, from);
+	span.size = strlen(span.data);
+	return span;
+}
+
+// -------------------------------------------------------------------------- //
+
 char8* lnUTF8Insert(const char8* string, u64 from, u64 count, const char8* insertion)
 {
 	assert(false && "NOT_IMPLEMENTED");
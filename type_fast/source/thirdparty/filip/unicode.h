@@ -61,6 +61,15 @@ typedef struct
   bool allow_numbers;        // 1234567890
 } DelimSettings;
 
+/**
+ * Range of bytes in a UTF-8 encoded string. Not null terminated.
+ */
+typedef struct
+{
+  const char8* data;
+  u64 size;
+} LnUTF8Span;
+
 // ========================================================================== //
 // UTF-8 Functions
 // ========================================================================== //
@@ -187,6 +196,33 @@ char8* lnUTF8SubstringFrom(const char8* string, u64 from);
 
 // -------------------------------------------------------------------------- //
 
+/** Returns the byte range of a substring of a UTF-8 encoded string from the
+ * specified 'from' index and 'count' number of indices forward. Unlike
+ * lnUTF8Substring nothing is allocated, the span points into 'string'.
+ * \note Returns an empty span if string is NULL.
+ * \note The range is clamped to the end of the string.
+ * \brief Returns UTF-8 substring span.
+ * \param string String to get substring of.
+ * \param from Index to get substring from.
+ * \param count Number of codepoints in substring.
+ * \return Span of the substring.
+ */
+LnUTF8Span lnUTF8Subspan(const char8* string, u64 from, u64 count);
+
+// -------------------------------------------------------------------------- //
+
+/** Returns the byte range of a substring of a UTF-8 encoded string from the
+ * specified 'from' index to the end of the string. Nothing is allocated.
+ * \note Returns an empty span if string is NULL.
+ * \brief Returns UTF-8 substring span.
+ * \param string String to get substring of.
+ * \param from Index to get substring from.
+ * \return Span of the substring.
+ */
+LnUTF8Span lnUTF8SubspanFrom(const char8* string, u64 from);
+
+// -------------------------------------------------------------------------- //
+
 char8* lnUTF8Insert(const char8* string, u64 from, u64 count, const char8* insertion);
 
 // -------------------------------------------------------------------------- //
@@ -0,0 +1,93 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CLOCK_HPP__
+#define __CLOCK_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <chrono>
+#include "types.hpp"
+
+// ============================================================ //
+// Functions
+// ============================================================ //
+
+namespace tf
+{
+
+using Clock = std::chrono::high_resolution_clock;
+
+/**
+ * Timestamps passed between threads and stored in events are plain
+ * microsecond counts of Clock, so they stay trivially copyable.
+ */
+inline u64 now_us()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        Clock::now().time_since_epoch()).count();
+}
+
+inline Clock::time_point from_us(u64 time_us)
+{
+    return Clock::time_point(std::chrono::duration_cast<Clock::duration>(
+                                 std::chrono::microseconds(time_us)));
+}
+
+// ============================================================ //
+// Class
+// ============================================================ //
+
+class Stopwatch
+{
+public:
+    void start() { m_start = Clock::now(); }
+    void stop() { m_stop = Clock::now(); }
+
+    /**
+     * Milliseconds between start and stop.
+     */
+    double fms() const
+        {
+            return std::chrono::duration<double, std::milli>(m_stop - m_start).count();
+        }
+
+    /**
+     * Milliseconds since start.
+     */
+    double fnow_ms() const
+        {
+            return std::chrono::duration<double, std::milli>(Clock::now() - m_start).count();
+        }
+
+private:
+    Clock::time_point m_start{Clock::now()};
+    Clock::time_point m_stop{m_start};
+};
+
+}
+
+#endif//__CLOCK_HPP__
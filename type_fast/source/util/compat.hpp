@@ -0,0 +1,70 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __COMPAT_HPP__
+#define __COMPAT_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <cstdio>
+#include <cstring>
+#include <cstdarg>
+#include <cerrno>
+
+// ============================================================ //
+// Functions
+// ============================================================ //
+
+// The bounds checked functions from MSVC, for other compilers.
+#ifndef _MSC_VER
+
+/**
+ * @return 0 on success, else @dest is empty and it returns ERANGE.
+ */
+inline int strcpy_s(char* dest, size_t size, const char* src)
+{
+    if (!dest || size == 0) return EINVAL;
+    const size_t len = strlen(src);
+    if (len >= size) {
+        dest[0] = 0;
+        return ERANGE;
+    }
+    memcpy(dest, src, len + 1);
+    return 0;
+}
+
+inline int sprintf_s(char* dest, size_t size, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const int res = vsnprintf(dest, size, format, args);
+    va_end(args);
+    return res;
+}
+
+#endif
+
+#endif//__COMPAT_HPP__
@@ -0,0 +1,93 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "fold.hpp"
+
+#include <cstring>
+#include "../thirdparty/filip/unicode.h"
+
+namespace tf
+{
+
+// '.' means the codepoint has no ASCII base letter and is only lowercased
+
+// U+00E0 to U+00FF
+static const char latin1_fold[] = "aaaaaa.ceeeeiiiidnooooo.ouuuuy.y";
+static_assert(sizeof(latin1_fold) == 0x20 + 1, "one entry per codepoint");
+
+// U+0100 to U+017F
+static const char latin_ext_a_fold[] =
+    "aaaaaa" "cccccccc" "dddd" "eeeeeeeeee" "gggggggg" "hhhh" "iiiiiiiiii" ".."
+    "jj" "kkk" "llllllllll" "nnnnnnnnn" "oooooo" ".." "rrrrrr" "ssssssss"
+    "tttttt" "uuuuuuuuuuuu" "ww" "yyy" "zzzzzz" "s";
+static_assert(sizeof(latin_ext_a_fold) == 0x80 + 1, "one entry per codepoint");
+
+u32 fold_codepoint(u32 codepoint)
+{
+    if (codepoint < 0x80) {
+        if (codepoint >= 'A' && codepoint <= 'Z') return codepoint + ('a' - 'A');
+        return codepoint;
+    }
+
+    if (codepoint >= 0xC0 && codepoint <= 0xFF) {
+        // uppercase lives 0x20 below its lowercase, except the multiplication
+        // sign and sharp s
+        if (codepoint == 0xD7 || codepoint == 0xDF) return codepoint;
+        if (codepoint < 0xE0) codepoint += 0x20;
+        const char base = latin1_fold[codepoint - 0xE0];
+        return base == '.' ? codepoint : static_cast<u32>(base);
+    }
+
+    if (codepoint >= 0x100 && codepoint <= 0x17F) {
+        const char base = latin_ext_a_fold[codepoint - 0x100];
+        if (base != '.') return static_cast<u32>(base);
+        // the ij and oe ligatures, uppercase is even
+        return codepoint | 1;
+    }
+
+    return codepoint;
+}
+
+int fold_utf8(const char* text, char* out, int out_size)
+{
+    if (out_size <= 0) return 0;
+
+    int bytes = 0;
+    u64 pos = 0;
+    while (text[pos] != 0) {
+        u64 codepoint;
+        u32 decoded;
+        if (!lnUTF8Decode(text, pos, &codepoint, &decoded)) break;
+        char folded[4];
+        const int encoded = lnUTF8Encode(folded, fold_codepoint(static_cast<u32>(codepoint)));
+        if (bytes + encoded >= out_size) break; // leave room for the null terminator
+        std::memcpy(out + bytes, folded, encoded);
+        bytes += encoded;
+        pos += decoded;
+    }
+    out[bytes] = 0;
+    return bytes;
+}
+
+}
@@ -22,39 +22,40 @@
  * SOFTWARE.
  */
 
-#ifndef __RAYLIB_LIFETIME_HPP__
-#define __RAYLIB_LIFETIME_HPP__
+#ifndef __FOLD_HPP__
+#define __FOLD_HPP__
 
 // ============================================================ //
 // Headers
 // ============================================================ //
 
-#include <raylib.h>
+#include "types.hpp"
 
 // ============================================================ //
-// Class
+// Functions
 // ============================================================ //
 
 namespace tf
 {
 
-class Raylib_lifetime
-{
-public:
-    Raylib_lifetime()
-	{
-            InitWindow(1280, 720, "Type Fast");
-            InitAudioDevice();
-        }
-
-    ~Raylib_lifetime()
-        {
-            CloseWindow();
+/**
+ * Fold a codepoint for case and diacritic insensitive matching. Latin letters
+ * are lowercased and lose their diacritics, "É" becomes "e". Everything else
+ * is returned as is.
+ *
+ * A codepoint always folds into one codepoint that is no longer in UTF-8, so
+ * a folded string has the same number of codepoints as the original and fits
+ * in the same buffer.
+ */
+u32 fold_codepoint(u32 codepoint);
 
-            CloseAudioDevice();
-        }
-};
+/**
+ * Fold every codepoint in @text into @out, null terminated.
+ * @param text Null terminated UTF-8 string.
+ * @return Bytes written, excluding the null terminator.
+ */
+int fold_utf8(const char* text, char* out, int out_size);
 
 }
 
-#endif//__RAYLIB_LIFETIME_HPP__
+#endif//__FOLD_HPP__
@@ -0,0 +1,222 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "frame_limiter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include "clock.hpp"
+
+namespace tf
+{
+
+// ============================================================ //
+// Duration_estimate
+// ============================================================ //
+
+void Duration_estimate::add(u64 sample_us)
+{
+    constexpr double gain = 0.125;
+    constexpr double deviation_gain = 0.25;
+    const double sample = static_cast<double>(sample_us);
+    if (m_first) {
+        m_mean_us = sample;
+        m_deviation_us = sample / 2;
+        m_first = false;
+        return;
+    }
+    m_deviation_us += deviation_gain * (std::fabs(sample - m_mean_us) - m_deviation_us);
+    m_mean_us += gain * (sample - m_mean_us);
+}
+
+// ============================================================ //
+// Jitter_histogram
+// ============================================================ //
+
+void Jitter_histogram::add(u64 jitter_us)
+{
+    const size_t bucket = static_cast<size_t>(jitter_us / bucket_us);
+    m_buckets[bucket < bucket_count ? bucket : bucket_count]++;
+    m_count++;
+    if (jitter_us > m_max_us) m_max_us = jitter_us;
+}
+
+void Jitter_histogram::reset()
+{
+    *this = Jitter_histogram{};
+}
+
+u64 Jitter_histogram::percentile_us(double p) const
+{
+    if (m_count == 0) return 0;
+    const u64 rank = static_cast<u64>(p * (m_count - 1)) + 1;
+    u64 seen = 0;
+    for (size_t i = 0; i < bucket_count; i++) {
+        seen += m_buckets[i];
+        if (seen >= rank) return (i + 1) * bucket_us;
+    }
+    return m_max_us;
+}
+
+// ============================================================ //
+// Frame_limiter
+// ============================================================ //
+
+void Frame_limiter::set_target_fps(int fps)
+{
+    const u64 period_us = fps > 0 ? 1000000 / static_cast<u64>(fps) : 0;
+    if (period_us == m_period_us) return;
+    m_period_us = period_us;
+    // restart the grid, else a lower rate would first wait for the old grid
+    m_next_us = 0;
+    // learned at the old rate, it may be a multiple of the refresh
+    m_refresh_us = 0;
+    m_refresh_window_count = 0;
+}
+
+void Frame_limiter::begin_frame()
+{
+    const u64 now = now_us();
+    if (m_period_us == 0) {
+        m_frame_start_us = now;
+        return;
+    }
+
+    if (m_next_us == 0) m_next_us = now;
+    u64 start_us = m_next_us;
+    u64 present_us = 0;
+    if (m_latency_mode && m_vsync && m_refresh_us != 0 && m_last_present_us != 0) {
+        // the first vertical blank the frame can make, not before the grid
+        const u64 work_us = static_cast<u64>(m_frame_work.upper_us());
+        const u64 earliest_us = std::max(m_next_us, now + work_us);
+        present_us = m_last_present_us + m_refresh_us;
+        if (present_us < earliest_us) {
+            present_us += (earliest_us - present_us + m_refresh_us - 1) / m_refresh_us * m_refresh_us;
+        }
+        start_us = present_us - work_us;
+    }
+    wait_until(start_us);
+    m_frame_start_us = now_us();
+
+    // in latency mode the grid is when frames are presented
+    m_scheduled_present = present_us != 0;
+    if (m_scheduled_present) m_next_us = present_us;
+    m_next_us += m_period_us;
+    // too late to catch up, skip the frames that were missed
+    if (m_next_us + m_period_us < m_frame_start_us) m_next_us = m_frame_start_us + m_period_us;
+}
+
+void Frame_limiter::work_done()
+{
+    m_work_done_us = now_us();
+}
+
+void Frame_limiter::end_frame()
+{
+    const u64 now = now_us();
+    m_frame_work.add((m_work_done_us != 0 ? m_work_done_us : now) - m_frame_start_us);
+    m_work_done_us = 0;
+
+    if (m_last_present_us != 0) {
+        const u64 interval_us = now - m_last_present_us;
+        if (m_vsync && !m_scheduled_present) add_present_interval(interval_us);
+        m_frames++;
+        m_interval_sum_us += static_cast<double>(interval_us);
+        m_interval_sum_sq_us += static_cast<double>(interval_us) * interval_us;
+        const u64 expected_us = expected_interval_us();
+        if (expected_us != 0) {
+            m_jitter.add(interval_us > expected_us ? interval_us - expected_us
+                                                   : expected_us - interval_us);
+        }
+    }
+    m_last_present_us = now;
+}
+
+void Frame_limiter::add_present_interval(u64 interval_us)
+{
+    // the median of a window ignores presents that were late or missed a
+    // refresh. When frames are slower than the display it's a multiple of
+    // the refresh, which still lines up with the vertical blanks. Frames
+    // latency mode placed aren't added, their spacing comes from the
+    // estimate and a bad one would never be corrected.
+    m_refresh_window[m_refresh_window_count++] = interval_us;
+    if (m_refresh_window_count == refresh_window) {
+        u64* median = m_refresh_window + refresh_window / 2;
+        std::nth_element(m_refresh_window, median, m_refresh_window + refresh_window);
+        m_refresh_us = *median;
+        m_refresh_window_count = 0;
+    }
+}
+
+u64 Frame_limiter::expected_interval_us() const
+{
+    if (m_period_us == 0 || !m_vsync || m_refresh_us == 0) return m_period_us;
+    return (m_period_us + m_refresh_us - 1) / m_refresh_us * m_refresh_us;
+}
+
+void Frame_limiter::wait_until(u64 time_us)
+{
+    // spin at least this long, sleeps shorter than it aren't worth the risk
+    constexpr u64 min_spin_us = 200;
+
+    u64 now = now_us();
+    const u64 margin_us = static_cast<u64>(m_sleep_overshoot.upper_us()) + min_spin_us;
+    if (time_us > now + margin_us) {
+        const u64 sleep_us = time_us - now - margin_us;
+        std::this_thread::sleep_for(std::chrono::microseconds(sleep_us));
+        const u64 slept_us = now_us() - now;
+        m_sleep_overshoot.add(slept_us > sleep_us ? slept_us - sleep_us : 0);
+        now = now_us();
+    }
+    while (now < time_us) {
+        std::this_thread::yield();
+        now = now_us();
+    }
+}
+
+Frame_stats Frame_limiter::stats() const
+{
+    Frame_stats stats{};
+    stats.frames = m_frames;
+    if (m_frames == 0) return stats;
+    stats.mean_us = m_interval_sum_us / m_frames;
+    const double variance = m_interval_sum_sq_us / m_frames - stats.mean_us * stats.mean_us;
+    stats.stddev_us = variance > 0 ? std::sqrt(variance) : 0;
+    stats.jitter_p50_us = m_jitter.percentile_us(0.5);
+    stats.jitter_p99_us = m_jitter.percentile_us(0.99);
+    stats.jitter_max_us = m_jitter.max_us();
+    return stats;
+}
+
+void Frame_limiter::reset_stats()
+{
+    m_jitter.reset();
+    m_frames = 0;
+    m_interval_sum_us = 0;
+    m_interval_sum_sq_us = 0;
+    m_last_present_us = 0;
+}
+
+}
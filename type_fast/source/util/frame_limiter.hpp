@@ -0,0 +1,206 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __FRAME_LIMITER_HPP__
+#define __FRAME_LIMITER_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <cstddef>
+#include "types.hpp"
+
+// ============================================================ //
+// Class
+// ============================================================ //
+
+namespace tf
+{
+
+/**
+ * Running estimate of a duration and how much it varies, like a TCP round
+ * trip estimate. upper() is what to plan for when being late is worse than
+ * being early.
+ */
+class Duration_estimate
+{
+public:
+    void add(u64 sample_us);
+
+    double mean_us() const { return m_mean_us; }
+    double upper_us() const { return m_mean_us + 4 * m_deviation_us; }
+
+private:
+    double m_mean_us = 0;
+    double m_deviation_us = 0;
+    bool m_first = true;
+};
+
+/**
+ * Histogram of how far frame intervals were from the target, fine enough for
+ * the precision of the spin. Anything above the last bucket goes in an
+ * overflow bucket.
+ */
+class Jitter_histogram
+{
+public:
+    static constexpr u64 bucket_us = 1;
+    static constexpr size_t bucket_count = 4000; // up to 4 ms
+
+    void add(u64 jitter_us);
+
+    void reset();
+
+    u64 count() const { return m_count; }
+    u64 max_us() const { return m_max_us; }
+
+    /**
+     * Upper bound of the bucket the @p percentile (0-1) falls in.
+     */
+    u64 percentile_us(double p) const;
+
+private:
+    u32 m_buckets[bucket_count + 1]{};
+    u64 m_count = 0;
+    u64 m_max_us = 0;
+};
+
+/**
+ * Statistics of the time between presented frames.
+ */
+struct Frame_stats
+{
+    u64 frames;
+    double mean_us;
+    double stddev_us;
+    // how far intervals were from the target, p50 and p99 of the histogram
+    u64 jitter_p50_us;
+    u64 jitter_p99_us;
+    u64 jitter_max_us;
+};
+
+/**
+ * Waits for the next frame with a coarse sleep followed by a spin. How long
+ * sleeps overshoot is measured as it runs, so it sleeps as much as it can
+ * while still waking up in time to spin to the deadline.
+ *
+ * Normally frames start on a fixed grid and are presented when they are
+ * done. With vsync the present then waits for the next vertical blank, up
+ * to a whole refresh after the input was sampled. In latency mode the frame
+ * start is delayed instead, so the frame is done just before the vertical
+ * blank and input is sampled as late as possible. The vertical blanks are
+ * estimated from when presents return while frames aren't delayed, so
+ * latency mode does nothing without vsync or for the first frames after the
+ * target changed.
+ *
+ * Usage:
+ *   limiter.begin_frame(); // waits
+ *   ...sample input, update, draw
+ *   limiter.work_done();
+ *   ...present
+ *   limiter.end_frame();
+ */
+class Frame_limiter
+{
+public:
+    /**
+     * @param fps 0 doesn't wait at all.
+     */
+    void set_target_fps(int fps);
+
+    /**
+     * If presents wait for the vertical blank.
+     */
+    void set_vsync(bool vsync) { m_vsync = vsync; }
+
+    void set_latency_mode(bool latency_mode) { m_latency_mode = latency_mode; }
+    bool latency_mode() const { return m_latency_mode; }
+
+    /**
+     * Wait until the frame should start.
+     */
+    void begin_frame();
+
+    /**
+     * Call when the frame is drawn, before it's presented. Waiting for the
+     * vertical blank isn't work, latency mode would start ever earlier.
+     */
+    void work_done();
+
+    /**
+     * Call after the frame was presented.
+     */
+    void end_frame();
+
+    Frame_stats stats() const;
+
+    void reset_stats();
+
+    /**
+     * Wait until @time_us, sleeping first and spinning for the last part.
+     */
+    void wait_until(u64 time_us);
+
+private:
+    /**
+     * Learn the refresh period from the time between presents.
+     */
+    void add_present_interval(u64 interval_us);
+
+    /**
+     * @return How long frames are apart when they keep up, the target
+     * period rounded up to whole refreshes with vsync.
+     */
+    u64 expected_interval_us() const;
+
+    u64 m_period_us = 0;
+    bool m_vsync = false;
+    bool m_latency_mode = false;
+    // the grid, when the next frame should start or be presented
+    u64 m_next_us = 0;
+    u64 m_frame_start_us = 0;
+    // 0 if work_done wasn't called this frame
+    u64 m_work_done_us = 0;
+    u64 m_last_present_us = 0;
+    // 0 until a window of present intervals was measured
+    u64 m_refresh_us = 0;
+    // latency mode chose the vertical blank of this frame
+    bool m_scheduled_present = false;
+    static constexpr size_t refresh_window = 31;
+    u64 m_refresh_window[refresh_window]{};
+    size_t m_refresh_window_count = 0;
+
+    Duration_estimate m_sleep_overshoot{};
+    Duration_estimate m_frame_work{};
+
+    Jitter_histogram m_jitter{};
+    u64 m_frames = 0;
+    double m_interval_sum_us = 0;
+    double m_interval_sum_sq_us = 0;
+};
+
+}
+
+#endif//__FRAME_LIMITER_HPP__
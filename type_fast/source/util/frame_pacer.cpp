@@ -0,0 +1,59 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "frame_pacer.hpp"
+
+namespace tf
+{
+
+Frame_pacer::Frame_pacer(int active_fps, int idle_fps, int sleep_fps)
+    : m_active_fps(active_fps), m_idle_fps(idle_fps), m_sleep_fps(sleep_fps),
+      m_fps(active_fps)
+{
+}
+
+void Frame_pacer::activity(u64 time_us)
+{
+    m_last_activity_us = time_us;
+    m_fps = m_active_fps;
+}
+
+int Frame_pacer::update(u64 time_us, bool animating)
+{
+    if (animating || !m_enabled) activity(time_us);
+
+    const u64 still_us = time_us > m_last_activity_us ? time_us - m_last_activity_us : 0;
+    if (still_us >= sleep_after_us) m_fps = m_sleep_fps;
+    else if (still_us >= idle_after_us) m_fps = m_idle_fps;
+    else m_fps = m_active_fps;
+    return m_fps;
+}
+
+void Frame_pacer::set_enabled(bool enabled)
+{
+    m_enabled = enabled;
+    m_fps = m_active_fps;
+}
+
+}
@@ -0,0 +1,90 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __FRAME_PACER_HPP__
+#define __FRAME_PACER_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include "types.hpp"
+
+// ============================================================ //
+// Class
+// ============================================================ //
+
+namespace tf
+{
+
+/**
+ * Picks the frame rate from how recently something happened. Runs at the
+ * full rate while anything animates or input arrives, drops to idle_fps when
+ * the screen has been still for a moment and to sleep_fps when it has been
+ * still for a long time. Any activity goes straight back to the full rate.
+ *
+ * Usage:
+ *   pacer.activity(now);             // key, click or a spawn
+ *   int fps = pacer.update(now, animating);
+ */
+class Frame_pacer
+{
+public:
+    static constexpr u64 idle_after_us = 1000000;
+    static constexpr u64 sleep_after_us = 30000000;
+
+    Frame_pacer() = default;
+    Frame_pacer(int active_fps, int idle_fps, int sleep_fps);
+
+    /**
+     * Something happened at @time_us, run at the full rate.
+     */
+    void activity(u64 time_us);
+
+    /**
+     * @param animating If anything on screen moves.
+     * @return The frame rate to run the next frame at.
+     */
+    int update(u64 time_us, bool animating);
+
+    int fps() const { return m_fps; }
+    bool is_idle() const { return m_fps != m_active_fps; }
+
+    /**
+     * Disabled it always runs at the full rate.
+     */
+    void set_enabled(bool enabled);
+
+private:
+    int m_active_fps = 60;
+    int m_idle_fps = 30;
+    int m_sleep_fps = 10;
+    int m_fps = 60;
+    u64 m_last_activity_us = 0;
+    bool m_enabled = true;
+};
+
+}
+
+#endif//__FRAME_PACER_HPP__
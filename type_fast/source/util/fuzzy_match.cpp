@@ -0,0 +1,116 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "fuzzy_match.hpp"
+
+#include <cstring>
+#include "utf8_simd.hpp"
+#include "../thirdparty/filip/unicode.h"
+
+namespace tf
+{
+
+void Fuzzy_matcher::set_pattern(const char* pattern)
+{
+    std::memset(m_peq_ascii, 0, sizeof(m_peq_ascii));
+    m_other_count = 0;
+    m_length = 0;
+
+    u64 pos = 0;
+    while (pattern[pos] != 0 && m_length < max_length) {
+        u64 codepoint;
+        u32 bytes;
+        if (!lnUTF8Decode(pattern, pos, &codepoint, &bytes)) break;
+        const u64 bit = u64{1} << m_length;
+        if (codepoint < ascii) {
+            m_peq_ascii[codepoint] |= bit;
+        }
+        else {
+            int i = 0;
+            while (i < m_other_count && m_other_codepoints[i] != codepoint) i++;
+            if (i == m_other_count) {
+                m_other_codepoints[i] = static_cast<u32>(codepoint);
+                m_other_peq[i] = 0;
+                m_other_count++;
+            }
+            m_other_peq[i] |= bit;
+        }
+        m_length++;
+        pos += bytes;
+    }
+}
+
+int Fuzzy_matcher::distance(const char* word, int max_edits) const
+{
+    size_t bytes = strlen(word);
+    if (bytes > max_word_bytes) bytes = max_word_bytes;
+    // the length the loop walks, invalid or cut sequences are one U+FFFD
+    // per byte, utf8_count_codepoints would count them differently
+    u32 codepoints[max_word_bytes];
+    const int word_length = static_cast<int>(utf8_to_utf32(word, bytes, codepoints));
+    const int length_diff = word_length > m_length ?
+        word_length - m_length : m_length - word_length;
+    if (length_diff > max_edits) return max_edits + 1;
+    if (m_length == 0) return word_length;
+
+    // Myers / Hyyro, global edit distance variant
+    const u64 mask = m_length == 64 ? ~u64{0} : (u64{1} << m_length) - 1;
+    const u64 high_bit = u64{1} << (m_length - 1);
+    u64 pv = mask;
+    u64 mv = 0;
+    int score = m_length;
+    int remaining = word_length;
+
+    for (int i = 0; i < word_length; i++) {
+        remaining--;
+
+        const u64 eq = peq(codepoints[i]);
+        const u64 xv = eq | mv;
+        const u64 xh = (((eq & pv) + pv) ^ pv) | eq;
+        u64 ph = mv | ~(xh | pv);
+        u64 mh = pv & xh;
+        if (ph & high_bit) score++;
+        else if (mh & high_bit) score--;
+        ph = (ph << 1) | 1;
+        mh = mh << 1;
+        pv = (mh | ~(xv | ph)) & mask;
+        mv = ph & xv & mask;
+
+        // each remaining codepoint can lower the score by at most one
+        if (score - remaining > max_edits) return max_edits + 1;
+    }
+
+    return score;
+}
+
+u64 Fuzzy_matcher::peq(u32 codepoint) const
+{
+    if (codepoint < ascii) return m_peq_ascii[codepoint];
+    for (int i = 0; i < m_other_count; i++) {
+        if (m_other_codepoints[i] == codepoint) return m_other_peq[i];
+    }
+    return 0;
+}
+
+}
@@ -0,0 +1,87 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __FUZZY_MATCH_HPP__
+#define __FUZZY_MATCH_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <cstddef>
+#include "types.hpp"
+
+// ============================================================ //
+// Class
+// ============================================================ //
+
+namespace tf
+{
+
+/**
+ * Levenshtein distance between one pattern and many words, using Myers'
+ * bit-parallel algorithm. The pattern is preprocessed once with
+ * set_pattern(), after which each distance() costs a handful of bit
+ * operations per codepoint in the word.
+ *
+ * Patterns are limited to 64 codepoints and words to 256 bytes, longer ones
+ * are cut.
+ */
+class Fuzzy_matcher
+{
+public:
+    /**
+     * @param pattern Null terminated UTF-8 string.
+     */
+    void set_pattern(const char* pattern);
+
+    /**
+     * @param word Null terminated UTF-8 string.
+     * @param max_edits Give up once the distance is known to exceed this.
+     * @return Edit distance between the pattern and @word, or a value larger
+     * than @max_edits if it is too far away.
+     */
+    int distance(const char* word, int max_edits) const;
+
+    int pattern_length() const { return m_length; }
+
+private:
+    u64 peq(u32 codepoint) const;
+
+private:
+    static constexpr int max_length = 64;
+    static constexpr size_t max_word_bytes = 256;
+    static constexpr int ascii = 128;
+
+    // bitmask of where each codepoint appears in the pattern
+    u64 m_peq_ascii[ascii]{};
+    u32 m_other_codepoints[max_length]{};
+    u64 m_other_peq[max_length]{};
+    int m_other_count = 0;
+    int m_length = 0;
+};
+
+}
+
+#endif//__FUZZY_MATCH_HPP__
@@ -0,0 +1,292 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "journal.hpp"
+
+#include "file.hpp"
+
+// allow us to use fopen
+#pragma warning(disable : 4996)
+
+namespace tf
+{
+
+static constexpr u8 journal_magic[4] = {'T', 'F', 'J', 1};
+
+u64 dictionary_id(const char* data, size_t size)
+{
+    u64 hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<u8>(data[i]);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static inline u64 zigzag(s64 value)
+{
+    return (static_cast<u64>(value) << 1) ^ static_cast<u64>(value >> 63);
+}
+
+static inline s64 unzigzag(u64 value)
+{
+    return static_cast<s64>(value >> 1) ^ -static_cast<s64>(value & 1);
+}
+
+// ============================================================ //
+// Writer
+// ============================================================ //
+
+Journal_writer::~Journal_writer()
+{
+    close();
+}
+
+bool Journal_writer::open(const char* path, const Journal_header& header)
+{
+    close();
+    m_file = fopen(path, "wb");
+    if (!m_file) return false;
+
+    m_block.reserve(block_size * 2);
+    m_pending.reserve(block_size * 2);
+    for (const u8 byte : journal_magic) put_byte(byte);
+    for (int i = 0; i < 8; i++) put_byte(static_cast<u8>(header.dictionary_id >> (i * 8)));
+    put_varint(header.start_time_us);
+    m_last_time_us = header.start_time_us;
+
+    m_quit = false;
+    m_has_pending = false;
+    m_thread = std::thread(&Journal_writer::run, this);
+    return true;
+}
+
+void Journal_writer::close()
+{
+    if (!m_file) return;
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_quit = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();
+
+    fwrite(m_block.data(), 1, m_block.size(), m_file);
+    m_block.clear();
+    fclose(m_file);
+    m_file = nullptr;
+}
+
+void Journal_writer::frame(u64 time_us)
+{
+    if (!m_file) return;
+    submit();
+    put_byte(static_cast<u8>(Journal_record_type::frame));
+    put_time(time_us);
+}
+
+void Journal_writer::keystroke(const Keystroke& key)
+{
+    if (!m_file) return;
+    put_byte(static_cast<u8>(Journal_record_type::keystroke));
+    put_byte(static_cast<u8>(key.kind));
+    if (key.kind == Keystroke_kind::text) put_varint(key.codepoint);
+    put_time(key.time_us);
+}
+
+void Journal_writer::slider(u32 index, s32 value)
+{
+    if (!m_file) return;
+    put_byte(static_cast<u8>(Journal_record_type::slider));
+    put_varint(index);
+    put_svarint(value);
+}
+
+void Journal_writer::reset(u32 seed)
+{
+    if (!m_file) return;
+    put_byte(static_cast<u8>(Journal_record_type::reset));
+    put_varint(seed);
+}
+
+void Journal_writer::put_varint(u64 value)
+{
+    while (value >= 0x80) {
+        put_byte(static_cast<u8>(value) | 0x80);
+        value >>= 7;
+    }
+    put_byte(static_cast<u8>(value));
+}
+
+void Journal_writer::put_svarint(s64 value)
+{
+    put_varint(zigzag(value));
+}
+
+void Journal_writer::put_time(u64 time_us)
+{
+    // keystrokes from the capture thread can be older than the frame
+    put_svarint(static_cast<s64>(time_us - m_last_time_us));
+    m_last_time_us = time_us;
+}
+
+void Journal_writer::submit()
+{
+    if (m_block.size() < block_size) return;
+    std::unique_lock<std::mutex> lock{m_mutex, std::try_to_lock};
+    if (!lock.owns_lock() || m_has_pending) return;
+    m_block.swap(m_pending);
+    m_has_pending = true;
+    lock.unlock();
+    m_cv.notify_one();
+}
+
+void Journal_writer::run()
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+    for (;;) {
+        m_cv.wait(lock, [this]() { return m_has_pending || m_quit; });
+        if (m_has_pending) {
+            lock.unlock();
+            fwrite(m_pending.data(), 1, m_pending.size(), m_file);
+            m_pending.clear();
+            lock.lock();
+            m_has_pending = false;
+        }
+        else if (m_quit) break;
+    }
+}
+
+// ============================================================ //
+// Reader
+// ============================================================ //
+
+bool Journal_reader::open(const char* path)
+{
+    File file{path};
+    if (file.has_error()) return false;
+
+    const u8* data = reinterpret_cast<const u8*>(file.get());
+    m_data.assign(data, data + file.get_size());
+    m_pos = 0;
+    m_corrupt = false;
+    if (m_data.size() < sizeof(journal_magic) + 8) return false;
+    for (const u8 byte : journal_magic) {
+        if (m_data[m_pos++] != byte) return false;
+    }
+    m_header.dictionary_id = 0;
+    for (int i = 0; i < 8; i++) {
+        m_header.dictionary_id |= static_cast<u64>(m_data[m_pos++]) << (i * 8);
+    }
+    if (!get_varint(m_header.start_time_us)) return false;
+    m_last_time_us = m_header.start_time_us;
+    return true;
+}
+
+Journal_record_type Journal_reader::peek() const
+{
+    if (at_end()) return Journal_record_type::none;
+    return static_cast<Journal_record_type>(m_data[m_pos]);
+}
+
+Journal_record Journal_reader::next()
+{
+    Journal_record record{};
+    if (at_end()) return record;
+
+    const auto type = static_cast<Journal_record_type>(m_data[m_pos++]);
+    u64 value = 0;
+    s64 svalue = 0;
+    bool ok = false;
+    switch (type) {
+    case Journal_record_type::frame: {
+        ok = get_time(record.time_us);
+        break;
+    }
+    case Journal_record_type::keystroke: {
+        if (at_end()) break;
+        record.key.kind = static_cast<Keystroke_kind>(m_data[m_pos++]);
+        ok = true;
+        if (record.key.kind == Keystroke_kind::text) {
+            ok = get_varint(value);
+            record.key.codepoint = static_cast<u32>(value);
+        }
+        ok = ok && get_time(record.key.time_us);
+        record.time_us = record.key.time_us;
+        break;
+    }
+    case Journal_record_type::slider: {
+        ok = get_varint(value) && get_svarint(svalue);
+        record.index = static_cast<u32>(value);
+        record.value = static_cast<s32>(svalue);
+        break;
+    }
+    case Journal_record_type::reset: {
+        ok = get_varint(value);
+        record.seed = static_cast<u32>(value);
+        break;
+    }
+    default: break;
+    }
+
+    if (ok) record.type = type;
+    else set_corrupt();
+    return record;
+}
+
+void Journal_reader::set_corrupt()
+{
+    m_pos = m_data.size();
+    m_corrupt = true;
+}
+
+bool Journal_reader::get_varint(u64& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && !at_end(); shift += 7) {
+        const u8 byte = m_data[m_pos++];
+        value |= static_cast<u64>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+bool Journal_reader::get_svarint(s64& value)
+{
+    u64 raw;
+    if (!get_varint(raw)) return false;
+    value = unzigzag(raw);
+    return true;
+}
+
+bool Journal_reader::get_time(u64& time_us)
+{
+    s64 delta;
+    if (!get_svarint(delta)) return false;
+    time_us = m_last_time_us + static_cast<u64>(delta);
+    m_last_time_us = time_us;
+    return true;
+}
+
+}
@@ -0,0 +1,207 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __JOURNAL_HPP__
+#define __JOURNAL_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <cstdio>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "types.hpp"
+#include "key_capture.hpp"
+
+// ============================================================ //
+// Types
+// ============================================================ //
+
+namespace tf
+{
+
+/**
+ * Everything needed to replay a session besides the records.
+ */
+struct Journal_header
+{
+    u64 dictionary_id; // see dictionary_id()
+    u64 start_time_us;
+};
+
+enum class Journal_record_type : u8
+{
+    none,
+    // an update began, time_us is the game time
+    frame,
+    keystroke,
+    // a slider was moved to value
+    slider,
+    // the game was reset and reseeded with seed
+    reset
+};
+
+struct Journal_record
+{
+    Journal_record_type type;
+    u64 time_us; // frame and keystroke
+    Keystroke key; // keystroke
+    u32 index; // slider
+    s32 value; // slider
+    u32 seed; // reset
+};
+
+/**
+ * Identifies the dictionary a journal was recorded with, so it's not replayed
+ * with a different one. FNV-1a of its contents.
+ */
+u64 dictionary_id(const char* data, size_t size);
+
+// ============================================================ //
+// Writer
+// ============================================================ //
+
+/**
+ * Records a session to a compact binary file. Numbers are LEB128 varints and
+ * times are deltas from the previous time in the journal, so a keystroke is
+ * usually 3-4 bytes.
+ *
+ * Records are appended to an in memory block. Full blocks are handed to a
+ * writer thread, so the game thread never waits on the disk. If the writer
+ * is still busy the block just keeps growing.
+ */
+class Journal_writer
+{
+public:
+    static constexpr size_t block_size = 16 * 1024;
+
+    Journal_writer() = default;
+    ~Journal_writer();
+
+    Journal_writer(const Journal_writer& other) = delete;
+    Journal_writer& operator=(const Journal_writer& other) = delete;
+
+    /**
+     * @return If the file could be opened.
+     */
+    bool open(const char* path, const Journal_header& header);
+
+    /**
+     * Write everything that's left and close the file.
+     */
+    void close();
+
+    bool is_open() const { return m_file != nullptr; }
+
+    void frame(u64 time_us);
+    void keystroke(const Keystroke& key);
+    void slider(u32 index, s32 value);
+    void reset(u32 seed);
+
+private:
+    void put_byte(u8 byte) { m_block.push_back(byte); }
+    void put_varint(u64 value);
+    void put_svarint(s64 value);
+    void put_time(u64 time_us);
+
+    /**
+     * Hand the block to the writer thread if it's full and the thread is idle.
+     */
+    void submit();
+
+    void run();
+
+    FILE* m_file = nullptr;
+    u64 m_last_time_us = 0;
+    std::vector<u8> m_block{};
+    // owned by the writer thread while m_has_pending
+    std::vector<u8> m_pending{};
+    bool m_has_pending = false;
+    bool m_quit = false;
+    std::mutex m_mutex{};
+    std::condition_variable m_cv{};
+    std::thread m_thread{};
+};
+
+// ============================================================ //
+// Reader
+// ============================================================ //
+
+/**
+ * Reads back a journal made by Journal_writer.
+ */
+class Journal_reader
+{
+public:
+    Journal_reader() = default;
+
+    /**
+     * Load the whole journal into memory.
+     * @return If it could be read and has a valid header.
+     */
+    bool open(const char* path);
+
+    const Journal_header& header() const { return m_header; }
+
+    /**
+     * @return The next record, or a record of type none at the end or if the
+     * journal is corrupt.
+     */
+    Journal_record next();
+
+    /**
+     * Look at the type of the next record without reading it.
+     */
+    Journal_record_type peek() const;
+
+    bool at_end() const { return m_pos >= m_data.size(); }
+
+    /**
+     * Stop reading, for journals the caller found invalid.
+     */
+    void set_corrupt();
+
+    /**
+     * @return If a record couldn't be decoded or the caller rejected one.
+     */
+    bool is_corrupt() const { return m_corrupt; }
+
+private:
+    bool get_varint(u64& value);
+    bool get_svarint(s64& value);
+    bool get_time(u64& time_us);
+
+    std::vector<u8> m_data{};
+    size_t m_pos = 0;
+    u64 m_last_time_us = 0;
+    bool m_corrupt = false;
+    Journal_header m_header{};
+};
+
+}
+
+#endif//__JOURNAL_HPP__
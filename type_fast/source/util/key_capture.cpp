@@ -0,0 +1,75 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "key_capture.hpp"
+
+#include "../platform/platform.hpp"
+
+namespace tf
+{
+
+// the capture thread is in key_capture_win.cpp, which can't include raylib
+#ifndef _WIN32
+
+void Key_capture::run() {}
+
+void Key_capture::start() {}
+
+void Key_capture::stop() {}
+
+#endif
+
+Key_capture::~Key_capture()
+{
+    stop();
+}
+
+void Key_capture::push(const Keystroke& key)
+{
+    if (!m_queue.push(key)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Key_capture::poll()
+{
+    if (is_threaded()) return;
+
+    const int last_key = platform::get_key_pressed();
+    Keystroke key{platform::time_us(), 0, Keystroke_kind::text};
+    if (last_key >= 33) {
+        key.codepoint = static_cast<u32>(last_key);
+        push(key);
+    }
+    else if (platform::is_key_pressed(KEY_BACKSPACE)) {
+        key.kind = Keystroke_kind::backspace;
+        push(key);
+    }
+    else if (platform::is_key_pressed(KEY_SPACE) || platform::is_key_pressed(KEY_ENTER)) {
+        key.kind = Keystroke_kind::submit;
+        push(key);
+    }
+}
+
+}
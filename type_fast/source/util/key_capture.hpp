@@ -0,0 +1,130 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __KEY_CAPTURE_HPP__
+#define __KEY_CAPTURE_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <thread>
+#include <atomic>
+#include "types.hpp"
+#include "spsc_queue.hpp"
+
+// ============================================================ //
+// Types
+// ============================================================ //
+
+namespace tf
+{
+
+enum class Keystroke_kind : u8
+{
+    text,
+    backspace,
+    // space or enter
+    submit
+};
+
+struct Keystroke
+{
+    u64 time_us; // see now_us
+    u32 codepoint; // only for text
+    Keystroke_kind kind;
+};
+
+// ============================================================ //
+// Class
+// ============================================================ //
+
+/**
+ * Captures keystrokes with their own timestamps, so typing speed is measured
+ * from when the key went down instead of when the next frame polled it, and a
+ * slow frame doesn't drop or coalesce keys.
+ *
+ * On Windows a low level keyboard hook runs on its own thread. Elsewhere, or
+ * if the hook can't be installed, keys are polled from raylib in poll().
+ */
+class Key_capture
+{
+public:
+    static constexpr size_t capacity = 256;
+
+    Key_capture() = default;
+    ~Key_capture();
+
+    Key_capture(const Key_capture& other) = delete;
+    Key_capture& operator=(const Key_capture& other) = delete;
+
+    /**
+     * Start the capture thread, call after the window is created.
+     */
+    void start();
+
+    void stop();
+
+    /**
+     * Call once per frame from the main thread, before draining. Does nothing
+     * while the capture thread is running.
+     */
+    void poll();
+
+    /**
+     * Game thread only.
+     * @return If a keystroke was written to @key.
+     */
+    bool pop(Keystroke& key) { return m_queue.pop(key); }
+
+    /**
+     * Any thread, only a hint while keys are arriving.
+     */
+    bool empty() const { return m_queue.empty(); }
+
+    bool is_threaded() const { return m_running.load(std::memory_order_acquire); }
+
+    /**
+     * Keystrokes dropped because the game thread didn't keep up.
+     */
+    u64 dropped_count() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * Called by the capture thread, or poll.
+     */
+    void push(const Keystroke& key);
+
+private:
+    void run();
+
+    Spsc_queue<Keystroke, capacity> m_queue{};
+    std::thread m_thread{};
+    std::atomic<bool> m_running{false};
+    std::atomic<u32> m_thread_id{0};
+    std::atomic<u64> m_dropped{0};
+};
+
+}
+
+#endif//__KEY_CAPTURE_HPP__
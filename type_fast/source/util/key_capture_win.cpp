@@ -0,0 +1,143 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Windows.h and raylib.h can't be included in the same file
+#ifdef _WIN32
+
+#include "key_capture.hpp"
+
+#define MEAN_AND_LEAN
+#define NO_MIN_MAX
+#include <Windows.h>
+#include "clock.hpp"
+#include "assert.hpp"
+
+namespace tf
+{
+
+// the hook procedure has no user data
+static Key_capture* s_capture = nullptr;
+
+/**
+ * Only capture keys meant for our window.
+ */
+static bool is_focused()
+{
+    DWORD pid = 0;
+    GetWindowThreadProcessId(GetForegroundWindow(), &pid);
+    return pid == GetCurrentProcessId();
+}
+
+/**
+ * Translate a virtual key to a codepoint with the foreground layout and the
+ * live modifier state, 0 if it isn't text.
+ */
+static u32 to_codepoint(const KBDLLHOOKSTRUCT* info)
+{
+    BYTE state[256] = {};
+    const int modifiers[] = {VK_SHIFT, VK_LSHIFT, VK_RSHIFT, VK_CONTROL, VK_LCONTROL,
+                             VK_RCONTROL, VK_MENU, VK_LMENU, VK_RMENU};
+    for (const int vk : modifiers) {
+        if (GetAsyncKeyState(vk) & 0x8000) state[vk] = 0x80;
+    }
+    if (GetKeyState(VK_CAPITAL) & 1) state[VK_CAPITAL] = 0x01;
+
+    const HKL layout = GetKeyboardLayout(
+        GetWindowThreadProcessId(GetForegroundWindow(), nullptr));
+    wchar_t utf16[4];
+    // flag 0x4 leaves the dead key state alone so the window still gets it
+    const int units = ToUnicodeEx(info->vkCode, info->scanCode, state,
+                                  utf16, 4, 0x4, layout);
+    if (units == 1) return utf16[0];
+    if (units == 2 && utf16[0] >= 0xD800 && utf16[0] < 0xDC00) {
+        return 0x10000 + ((utf16[0] - 0xD800) << 10) + (utf16[1] - 0xDC00);
+    }
+    return 0;
+}
+
+static LRESULT CALLBACK keyboard_hook(int code, WPARAM wparam, LPARAM lparam)
+{
+    if (code == HC_ACTION && (wparam == WM_KEYDOWN || wparam == WM_SYSKEYDOWN)
+        && is_focused()) {
+        const auto* info = reinterpret_cast<const KBDLLHOOKSTRUCT*>(lparam);
+        Keystroke key{now_us(), 0, Keystroke_kind::text};
+        if (info->vkCode == VK_BACK) {
+            key.kind = Keystroke_kind::backspace;
+            s_capture->push(key);
+        }
+        else if (info->vkCode == VK_SPACE || info->vkCode == VK_RETURN) {
+            key.kind = Keystroke_kind::submit;
+            s_capture->push(key);
+        }
+        else if ((key.codepoint = to_codepoint(info)) != 0) {
+            s_capture->push(key);
+        }
+    }
+    return CallNextHookEx(nullptr, code, wparam, lparam);
+}
+
+void Key_capture::run()
+{
+    const HHOOK hook = SetWindowsHookExW(WH_KEYBOARD_LL, keyboard_hook,
+                                         GetModuleHandleW(nullptr), 0);
+    m_running.store(hook != nullptr, std::memory_order_release);
+    m_thread_id.store(GetCurrentThreadId(), std::memory_order_release);
+    if (!hook) return;
+
+    // low level hooks are called through this threads message loop
+    MSG msg;
+    while (GetMessageW(&msg, nullptr, 0, 0) > 0) {
+        TranslateMessage(&msg);
+        DispatchMessageW(&msg);
+    }
+    UnhookWindowsHookEx(hook);
+}
+
+void Key_capture::start()
+{
+    tf_assert(!m_thread.joinable(), "key capture already started");
+    s_capture = this;
+    m_thread = std::thread(&Key_capture::run, this);
+    while (m_thread_id.load(std::memory_order_acquire) == 0) {
+        std::this_thread::yield();
+    }
+    if (!is_threaded()) { // fall back to polling
+        m_thread.join();
+        m_thread_id.store(0, std::memory_order_release);
+    }
+}
+
+void Key_capture::stop()
+{
+    if (!m_thread.joinable()) return;
+    PostThreadMessageW(m_thread_id.load(std::memory_order_acquire), WM_QUIT, 0, 0);
+    m_thread.join();
+    m_running.store(false, std::memory_order_release);
+    m_thread_id.store(0, std::memory_order_release);
+    s_capture = nullptr;
+}
+
+}
+
+#endif
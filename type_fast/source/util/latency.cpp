@@ -0,0 +1,129 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "latency.hpp"
+
+#include <cstdio>
+#include "clock.hpp"
+
+// allow us to use fopen
+#pragma warning(disable : 4996)
+
+namespace tf
+{
+
+// ============================================================ //
+// Histogram
+// ============================================================ //
+
+void Latency_histogram::add(u64 latency_us)
+{
+    const size_t bucket = static_cast<size_t>(latency_us / bucket_us);
+    m_buckets[bucket < bucket_count ? bucket : bucket_count]++;
+    m_count++;
+    m_total_us += latency_us;
+    if (latency_us > m_max_us) m_max_us = latency_us;
+}
+
+void Latency_histogram::reset()
+{
+    *this = Latency_histogram{};
+}
+
+u64 Latency_histogram::percentile_us(double p) const
+{
+    if (m_count == 0) return 0;
+    const u64 rank = static_cast<u64>(p * (m_count - 1)) + 1;
+    u64 seen = 0;
+    for (size_t i = 0; i < bucket_count; i++) {
+        seen += m_buckets[i];
+        if (seen >= rank) return (i + 1) * bucket_us;
+    }
+    return m_max_us;
+}
+
+// ============================================================ //
+// Tracker
+// ============================================================ //
+
+void Latency_tracker::begin_frame(const Keystroke* keys, size_t key_count)
+{
+    m_key_count = 0;
+    if (!m_enabled) return;
+    for (size_t i = 0; i < key_count && i < Key_capture::capacity; i++) {
+        m_capture_us[m_key_count++] = keys[i].time_us;
+    }
+}
+
+void Latency_tracker::mark(Stage stage)
+{
+    if (m_key_count == 0) return;
+    add(stage, now_us(), m_capture_us, m_key_count);
+}
+
+void Latency_tracker::add(Stage stage, u64 time_us, const u64* capture_us, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        m_histograms[stage].add(time_us > capture_us[i] ? time_us - capture_us[i] : 0);
+    }
+}
+
+void Latency_tracker::reset()
+{
+    m_key_count = 0;
+    for (auto& histogram : m_histograms) histogram.reset();
+}
+
+bool Latency_tracker::export_csv(const char* path) const
+{
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+
+    fprintf(file, "bucket_ms");
+    for (int stage = 0; stage < stage_count; stage++) {
+        fprintf(file, ",%s", latency_stage_to_string(static_cast<Stage>(stage)));
+    }
+    fprintf(file, "\n");
+    for (size_t i = 0; i <= Latency_histogram::bucket_count; i++) {
+        fprintf(file, "%.1f", i * Latency_histogram::bucket_us / 1000.0);
+        for (const auto& histogram : m_histograms) {
+            fprintf(file, ",%u", histogram.bucket(i));
+        }
+        fprintf(file, "\n");
+    }
+    fclose(file);
+    return true;
+}
+
+const char* latency_stage_to_string(Latency_tracker::Stage stage)
+{
+    switch (stage) {
+    case Latency_tracker::input: return "input";
+    case Latency_tracker::highlight: return "highlight";
+    case Latency_tracker::present: return "present";
+    default: return "unknown";
+    }
+}
+
+}
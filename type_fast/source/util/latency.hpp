@@ -0,0 +1,148 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __LATENCY_HPP__
+#define __LATENCY_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <cstddef>
+#include "types.hpp"
+#include "key_capture.hpp"
+
+// ============================================================ //
+// Class
+// ============================================================ //
+
+namespace tf
+{
+
+/**
+ * Histogram of latencies with fixed width buckets, anything above the last
+ * bucket goes in an overflow bucket.
+ */
+class Latency_histogram
+{
+public:
+    static constexpr u64 bucket_us = 100;
+    static constexpr size_t bucket_count = 1000; // up to 100 ms
+
+    void add(u64 latency_us);
+
+    void reset();
+
+    u64 count() const { return m_count; }
+    u64 max_us() const { return m_max_us; }
+    double mean_us() const { return m_count ? (double)m_total_us / m_count : 0.0; }
+
+    /**
+     * Upper bound of the bucket the @p percentile (0-1) falls in.
+     */
+    u64 percentile_us(double p) const;
+
+    /**
+     * @param bucket bucket_count is the overflow bucket.
+     */
+    u32 bucket(size_t bucket) const { return m_buckets[bucket]; }
+
+private:
+    u32 m_buckets[bucket_count + 1]{};
+    u64 m_count = 0;
+    u64 m_total_us = 0;
+    u64 m_max_us = 0;
+};
+
+/**
+ * Traces the keystrokes of a frame from when they were captured, through the
+ * stages of the frame, until the frame is presented.
+ *
+ * Usage:
+ * 1. begin_frame() with the keystrokes drained this frame.
+ * 2. mark() each stage after it's done.
+ * 3. When the frame was presented, add() the present stage with the
+ *    capture_times() of that frame. The frame may be presented on another
+ *    thread, after the next begin_frame().
+ */
+class Latency_tracker
+{
+public:
+    enum Stage
+    {
+        // the input box consumed the keys
+        input,
+        // the words were highlighted
+        highlight,
+        // EndDrawing returned
+        present,
+        stage_count
+    };
+
+    void begin_frame(const Keystroke* keys, size_t key_count);
+
+    /**
+     * Add the latency of every key in the frame to the histogram of @stage.
+     * After present, the keys are forgotten.
+     */
+    void mark(Stage stage);
+
+    /**
+     * Add the latency from each of @capture_us to @time_us to @stage.
+     */
+    void add(Stage stage, u64 time_us, const u64* capture_us, size_t count);
+
+    /**
+     * Capture times of the keys in the current frame.
+     */
+    const u64* capture_times() const { return m_capture_us; }
+    size_t key_count() const { return m_key_count; }
+
+    /**
+     * Stop tracking, for when the keystroke times aren't real, like in replays.
+     */
+    void set_enabled(bool enabled) { m_enabled = enabled; }
+
+    const Latency_histogram& histogram(Stage stage) const { return m_histograms[stage]; }
+
+    void reset();
+
+    /**
+     * Write the histograms as CSV, one row per bucket.
+     * @return If the file could be written.
+     */
+    bool export_csv(const char* path) const;
+
+private:
+    u64 m_capture_us[Key_capture::capacity];
+    size_t m_key_count = 0;
+    bool m_enabled = true;
+    Latency_histogram m_histograms[stage_count];
+};
+
+const char* latency_stage_to_string(Latency_tracker::Stage stage);
+
+}
+
+#endif//__LATENCY_HPP__
@@ -0,0 +1,181 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __OBJECT_POOL_HPP__
+#define __OBJECT_POOL_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <cstddef>
+#include <vector>
+#include "types.hpp"
+
+// ============================================================ //
+// Class
+// ============================================================ //
+
+namespace tf
+{
+
+/**
+ * Refers to an object in an Object_pool, safe to use after it was released.
+ */
+struct Pool_handle
+{
+    u32 index = 0;
+    u32 generation = 0; // 0 is never acquired
+};
+
+/**
+ * Recycles objects of one type. Released slots go on a free list and are
+ * handed out again before the pool grows, so transient objects stop
+ * allocating once the pool is big enough. Acquire and release are O(1), and
+ * the live objects are kept in a dense list so iterating skips free slots.
+ *
+ * Objects may move when the pool grows, keep handles rather than pointers.
+ *
+ * Usage:
+ *   Pool_handle flash = pool.acquire(rect);
+ *   pool.release_if([](H_scroll<Rect>& r) { return update(r, width); });
+ */
+template <typename T>
+class Object_pool
+{
+public:
+    Pool_handle acquire(const T& object)
+        {
+            u32 index;
+            if (!m_free.empty()) {
+                index = m_free.back();
+                m_free.pop_back();
+                m_slots[index].object = object;
+            }
+            else {
+                index = static_cast<u32>(m_slots.size());
+                m_slots.push_back({object, 0, 0});
+            }
+            Slot& slot = m_slots[index];
+            slot.generation++;
+            slot.live_pos = static_cast<u32>(m_live.size());
+            m_live.push_back(index);
+            return {index, slot.generation};
+        }
+
+    /**
+     * @return If @handle was live.
+     */
+    bool release(const Pool_handle& handle)
+        {
+            if (!is_live(handle)) return false;
+            release_index(handle.index);
+            return true;
+        }
+
+    bool is_live(const Pool_handle& handle) const
+        {
+            return handle.generation != 0 && handle.index < m_slots.size() &&
+                m_slots[handle.index].generation == handle.generation &&
+                m_slots[handle.index].live_pos != free_pos;
+        }
+
+    /**
+     * @return The object, or nullptr when @handle was released.
+     */
+    T* get(const Pool_handle& handle)
+        {
+            return is_live(handle) ? &m_slots[handle.index].object : nullptr;
+        }
+
+    /**
+     * Call fn(T&) for every live object.
+     */
+    template <typename TFn>
+    void for_each(TFn&& fn)
+        {
+            for (const u32 index : m_live) fn(m_slots[index].object);
+        }
+
+    template <typename TFn>
+    void for_each(TFn&& fn) const
+        {
+            for (const u32 index : m_live) fn(m_slots[index].object);
+        }
+
+    /**
+     * Call pred(T&) for every live object and release it when it returns true.
+     */
+    template <typename TPred>
+    void release_if(TPred&& pred)
+        {
+            // backwards, so the object swapped in has already been seen
+            for (size_t i = m_live.size(); i-- > 0;) {
+                if (pred(m_slots[m_live[i]].object)) release_index(m_live[i]);
+            }
+        }
+
+    void clear()
+        {
+            for (const u32 index : m_live) {
+                m_slots[index].live_pos = free_pos;
+                m_free.push_back(index);
+            }
+            m_live.clear();
+        }
+
+    size_t size() const { return m_live.size(); }
+    bool empty() const { return m_live.empty(); }
+    size_t capacity() const { return m_slots.size(); }
+
+private:
+    static constexpr u32 free_pos = 0xFFFFFFFF;
+
+    struct Slot
+    {
+        T object;
+        u32 generation;
+        // where in m_live it is, free_pos when released
+        u32 live_pos;
+    };
+
+    void release_index(u32 index)
+        {
+            const u32 pos = m_slots[index].live_pos;
+            const u32 last = m_live.back();
+            m_live[pos] = last;
+            m_slots[last].live_pos = pos;
+            m_live.pop_back();
+            m_slots[index].live_pos = free_pos;
+            m_free.push_back(index);
+        }
+
+    std::vector<Slot> m_slots;
+    std::vector<u32> m_free;
+    std::vector<u32> m_live;
+};
+
+}
+
+#endif//__OBJECT_POOL_HPP__
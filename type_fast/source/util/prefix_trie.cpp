@@ -0,0 +1,228 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "prefix_trie.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include "utf8_simd.hpp"
+
+namespace tf
+{
+
+// ============================================================ //
+// Helpers
+// ============================================================ //
+
+static int decode(const char* text, u32* out)
+{
+    const size_t bytes = strnlen(text, constants::word_size);
+    // the buffer holds at most word_size codepoints, there is room for all
+    return static_cast<int>(utf8_to_utf32(text, bytes, out));
+}
+
+// ============================================================ //
+// Prefix_trie
+// ============================================================ //
+
+Prefix_trie::Prefix_trie()
+{
+    clear();
+}
+
+void Prefix_trie::clear()
+{
+    m_nodes.clear();
+    m_free_nodes.clear();
+    m_nodes.push_back({0, none, none, none, none, 0, 0});
+    std::fill(m_id_node.begin(), m_id_node.end(), none);
+    m_path[0] = 0;
+    m_path_length = 0;
+}
+
+int Prefix_trie::insert(u32 id, const char* key)
+{
+    if (id >= m_id_node.size()) {
+        m_id_node.resize(id + 1, none);
+        m_id_next.resize(id + 1, none);
+    }
+
+    u32 codepoints[max_depth];
+    const int length = decode(key, codepoints);
+    u32 node = 0;
+    m_nodes[0].count++;
+    for (int i = 0; i < length; i++) {
+        u32 next = child(node, codepoints[i]);
+        if (next == none) next = add_child(node, codepoints[i]);
+        node = next;
+        m_nodes[node].count++;
+    }
+    m_id_node[id] = node;
+    m_id_next[id] = m_nodes[node].first_id;
+    m_nodes[node].first_id = id;
+
+    // the new nodes may take the cursor further, nothing else is under them
+    extend_path();
+    int count = 0;
+    for (u32 n = node; n != none; n = m_nodes[n].parent) {
+        if (on_path(n)) {
+            count = static_cast<int>(m_nodes[n].depth);
+            break;
+        }
+    }
+    return count;
+}
+
+void Prefix_trie::remove(u32 id)
+{
+    const u32 node = m_id_node[id];
+    if (node == none) return;
+    m_id_node[id] = none;
+
+    u32* link = &m_nodes[node].first_id;
+    while (*link != id) link = &m_id_next[*link];
+    *link = m_id_next[id];
+
+    // nodes the cursor is on stay until it leaves them
+    for (u32 n = node; n != none;) {
+        const u32 parent = m_nodes[n].parent;
+        m_nodes[n].count--;
+        if (m_nodes[n].count == 0 && n != 0 && !on_path(n)) free_node(n);
+        n = parent;
+    }
+}
+
+const std::vector<Prefix_change>& Prefix_trie::set_input(const char* input)
+{
+    m_changes.clear();
+
+    // the input is the same most frames, see that on the bytes
+    char text[max_depth + 1] = {};
+    strncpy(text, input, max_depth);
+    if (memcmp(text, m_input_text, sizeof(text)) == 0) return m_changes;
+
+    // whole codepoints up to the first differing byte, these decode the same
+    // in both inputs, an invalid byte only makes the count smaller
+    const int same = utf8_common_prefix(m_input_text, text, sizeof(text));
+    memcpy(m_input_text, text, sizeof(text));
+    m_input_length = decode(text, m_input);
+
+    // the cursor keeps the part of the path both inputs share
+    const int kept = same < m_path_length ? same : m_path_length;
+    const u32 old_next = kept < m_path_length ? m_path[kept + 1] : none;
+    const int old_length = m_path_length;
+    u32 old_path[max_depth + 1];
+    memcpy(old_path, m_path, (old_length + 1) * sizeof(u32));
+
+    m_path_length = kept;
+    extend_path();
+    const u32 new_next = kept < m_path_length ? m_path[kept + 1] : none;
+
+    // every key under where the paths split gets its new count
+    if (old_next != none) collect(old_next);
+    if (new_next != none && new_next != old_next) collect(new_next);
+
+    // the nodes the cursor left that nothing ends under anymore
+    for (int depth = old_length; depth > kept; depth--) {
+        const u32 node = old_path[depth];
+        if (m_nodes[node].count == 0 && !on_path(node)) free_node(node);
+    }
+    return m_changes;
+}
+
+// ============================================================ //
+
+u32 Prefix_trie::child(u32 node, u32 codepoint) const
+{
+    for (u32 c = m_nodes[node].first_child; c != none; c = m_nodes[c].next_sibling) {
+        if (m_nodes[c].codepoint == codepoint) return c;
+    }
+    return none;
+}
+
+u32 Prefix_trie::add_child(u32 node, u32 codepoint)
+{
+    u32 index;
+    if (!m_free_nodes.empty()) {
+        index = m_free_nodes.back();
+        m_free_nodes.pop_back();
+    }
+    else {
+        index = static_cast<u32>(m_nodes.size());
+        m_nodes.push_back({});
+    }
+    m_nodes[index] = {codepoint, node, none, m_nodes[node].first_child, none, 0,
+                      m_nodes[node].depth + 1};
+    m_nodes[node].first_child = index;
+    return index;
+}
+
+void Prefix_trie::free_node(u32 node)
+{
+    // only empty leaves are freed, children go first
+    u32* link = &m_nodes[m_nodes[node].parent].first_child;
+    while (*link != node) link = &m_nodes[*link].next_sibling;
+    *link = m_nodes[node].next_sibling;
+    m_free_nodes.push_back(node);
+}
+
+bool Prefix_trie::on_path(u32 node) const
+{
+    const int depth = static_cast<int>(m_nodes[node].depth);
+    return depth <= m_path_length && m_path[depth] == node;
+}
+
+void Prefix_trie::extend_path()
+{
+    while (m_path_length < m_input_length) {
+        const u32 next = child(m_path[m_path_length], m_input[m_path_length]);
+        if (next == none) break;
+        m_path[++m_path_length] = next;
+    }
+}
+
+void Prefix_trie::collect(u32 node)
+{
+    // the count of a key is the depth of its deepest ancestor on the path
+    const u32 parent = m_nodes[node].parent;
+    m_stack.clear();
+    m_stack.push_back(node);
+    m_stack.push_back(on_path(parent) ? m_nodes[parent].depth : 0);
+    while (!m_stack.empty()) {
+        u32 count = m_stack.back();
+        m_stack.pop_back();
+        const u32 n = m_stack.back();
+        m_stack.pop_back();
+        if (on_path(n)) count = m_nodes[n].depth;
+        for (u32 id = m_nodes[n].first_id; id != none; id = m_id_next[id]) {
+            m_changes.push_back({id, static_cast<int>(count)});
+        }
+        for (u32 c = m_nodes[n].first_child; c != none; c = m_nodes[c].next_sibling) {
+            m_stack.push_back(c);
+            m_stack.push_back(count);
+        }
+    }
+}
+
+}
@@ -0,0 +1,143 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __PREFIX_TRIE_HPP__
+#define __PREFIX_TRIE_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <vector>
+#include "types.hpp"
+#include "../widget/constants.hpp"
+
+// ============================================================ //
+// Class
+// ============================================================ //
+
+namespace tf
+{
+
+/**
+ * How many codepoints the key of @id has in common with the input.
+ */
+struct Prefix_change
+{
+    u32 id;
+    int count;
+};
+
+/**
+ * Trie over the codepoints of a set of keys, with a cursor that follows the
+ * input as far as any key does. Each key knows how many codepoints it has in
+ * common with the input from where the cursor is, so when the input changes
+ * only the keys below the nodes the cursor entered or left are visited.
+ * Typing a letter costs the keys that start with the new input, not every
+ * key.
+ *
+ * Keys and inputs are constants::word_size buffers of UTF-8.
+ *
+ * Usage:
+ *   int count = trie.insert(id, key);
+ *   for (auto change : trie.set_input(input)) { ... }
+ *   trie.remove(id);
+ */
+class Prefix_trie
+{
+public:
+    Prefix_trie();
+
+    /**
+     * @id Any number, at most one key per id.
+     * @return How many codepoints @key has in common with the input.
+     */
+    int insert(u32 id, const char* key);
+
+    void remove(u32 id);
+
+    /**
+     * Remove every key, the input is kept.
+     */
+    void clear();
+
+    /**
+     * Move the cursor to @input.
+     * @return The keys whose count changed, valid until the next call.
+     */
+    const std::vector<Prefix_change>& set_input(const char* input);
+
+private:
+    static constexpr u32 none = 0xFFFFFFFF;
+    static constexpr int max_depth = constants::word_size;
+
+    struct Node
+    {
+        u32 codepoint;
+        u32 parent;
+        u32 first_child;
+        u32 next_sibling;
+        // first id whose key ends here, the rest follow m_id_next
+        u32 first_id;
+        // keys ending in this subtree
+        u32 count;
+        u32 depth;
+    };
+
+    u32 child(u32 node, u32 codepoint) const;
+    u32 add_child(u32 node, u32 codepoint);
+    void free_node(u32 node);
+    bool on_path(u32 node) const;
+
+    /**
+     * Move the cursor down the input as far as the trie goes.
+     */
+    void extend_path();
+
+    /**
+     * Add the count of every key under @node to m_changes.
+     */
+    void collect(u32 node);
+
+    std::vector<Node> m_nodes;
+    std::vector<u32> m_free_nodes;
+    // by id
+    std::vector<u32> m_id_node;
+    std::vector<u32> m_id_next;
+
+    u32 m_input[max_depth];
+    int m_input_length = 0;
+    // the input as given, zero padded, to tell what changed before decoding
+    char m_input_text[max_depth + 1] = {};
+    // m_path[d] is the node of the first d codepoints of the input
+    u32 m_path[max_depth + 1];
+    int m_path_length = 0; // deepest node, the root is 0
+
+    std::vector<Prefix_change> m_changes;
+    std::vector<u32> m_stack;
+};
+
+}
+
+#endif//__PREFIX_TRIE_HPP__
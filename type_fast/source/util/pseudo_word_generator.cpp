@@ -0,0 +1,269 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pseudo_word_generator.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <unordered_map>
+#include "utf8_simd.hpp"
+#include "../thirdparty/filip/unicode.h"
+
+namespace tf
+{
+
+void Pseudo_word_generator::train(const std::vector<std::string>& words)
+{
+    m_ready = false;
+    m_alphabet.clear();
+    m_alphabet.push_back(0); // boundary
+
+    // First pass, find the alphabet
+    std::unordered_map<u32, u16> symbols{};
+    std::vector<u32> codepoints{};
+    for (const auto& word : words) {
+        codepoints.resize(word.size());
+        const size_t count = utf8_to_utf32(word.c_str(), word.size(), codepoints.data());
+        for (size_t i = 0; i < count; i++) {
+            const u32 cp = codepoints[i];
+            if (symbols.find(cp) == symbols.end() && m_alphabet.size() < max_symbols) {
+                symbols[cp] = static_cast<u16>(m_alphabet.size());
+                m_alphabet.push_back(cp);
+            }
+        }
+    }
+
+    // Second pass, count the transitions. Words with letters that did not
+    // fit in the alphabet are skipped.
+    const size_t n = m_alphabet.size();
+    m_bigram_counts.assign(n * n, 0);
+    m_trigram_counts.assign(n * n * n, 0);
+    std::vector<u16> sequence{};
+    for (const auto& word : words) {
+        sequence.clear();
+        sequence.push_back(boundary);
+        sequence.push_back(boundary);
+        bool valid = true;
+        codepoints.resize(word.size());
+        const size_t count = utf8_to_utf32(word.c_str(), word.size(), codepoints.data());
+        for (size_t i = 0; i < count; i++) {
+            const auto it = symbols.find(codepoints[i]);
+            if (it == symbols.end()) {
+                valid = false;
+                break;
+            }
+            sequence.push_back(it->second);
+        }
+        if (!valid || sequence.size() == 2) continue;
+        sequence.push_back(boundary);
+
+        for (size_t i = 2; i < sequence.size(); i++) {
+            m_bigram_counts[sequence[i-1] * n + sequence[i]]++;
+            m_trigram_counts[(sequence[i-2] * n + sequence[i-1]) * n + sequence[i]]++;
+        }
+    }
+}
+
+bool Pseudo_word_generator::set_allowed(const char* letters, int min_length,
+                                        int max_length)
+{
+    m_ready = false;
+    const size_t n = m_alphabet.size();
+    if (!letters || n == 0) return false;
+
+    m_allowed.assign(n, false);
+    bool any = false;
+    u64 pos = 0;
+    while (letters[pos] != 0) {
+        u64 codepoint;
+        u32 bytes;
+        if (!lnUTF8Decode(letters, pos, &codepoint, &bytes)) break;
+        const u16 symbol = symbol_of(static_cast<u32>(codepoint));
+        if (symbol != boundary) {
+            m_allowed[symbol] = true;
+            any = true;
+        }
+        pos += bytes;
+    }
+
+    m_min_length = min_length > 1 ? min_length : 1;
+    m_max_length = max_length > m_min_length ? max_length : m_min_length;
+
+    m_prob.clear();
+    m_alias.clear();
+    m_symbol.clear();
+    const auto reachable = [this](size_t symbol) {
+        return symbol == boundary || m_allowed[symbol];
+    };
+
+    m_order2_tables.assign(n * n * 2, Alias_table{0, 0});
+    for (size_t prev2 = 0; prev2 < n; prev2++) {
+        if (!reachable(prev2)) continue;
+        for (size_t prev1 = 0; prev1 < n; prev1++) {
+            if (!reachable(prev1)) continue;
+            const size_t context = prev2 * n + prev1;
+            const u32* counts = &m_trigram_counts[context * n];
+            m_order2_tables[context*2] = build_table(counts, false);
+            m_order2_tables[context*2 + 1] = build_table(counts, true);
+        }
+    }
+
+    m_order1_tables.assign(n * 2, Alias_table{0, 0});
+    for (size_t prev1 = 0; prev1 < n; prev1++) {
+        if (!reachable(prev1)) continue;
+        const u32* counts = &m_bigram_counts[prev1 * n];
+        m_order1_tables[prev1*2] = build_table(counts, false);
+        m_order1_tables[prev1*2 + 1] = build_table(counts, true);
+    }
+
+    // uniform over the allowed letters, for contexts never seen in training
+    const std::vector<u32> uniform(n, 1);
+    m_order0_tables[0] = build_table(uniform.data(), false);
+    m_order0_tables[1] = build_table(uniform.data(), true);
+
+    m_ready = any;
+    return any;
+}
+
+int Pseudo_word_generator::next(char* out, int out_size)
+{
+    return generate(boundary, out, out_size);
+}
+
+int Pseudo_word_generator::next_starting_with(u32 codepoint, char* out, int out_size)
+{
+    const u16 first = symbol_of(codepoint);
+    const bool allowed = m_ready && first != boundary && m_allowed[first];
+    return generate(allowed ? first : boundary, out, out_size);
+}
+
+int Pseudo_word_generator::generate(u16 first, char* out, int out_size)
+{
+    if (out_size <= 0) return 0;
+    out[0] = 0;
+    if (!m_ready) return 0;
+
+    const size_t n = m_alphabet.size();
+    int bytes = 0;
+    for (int attempt = 0; attempt < max_attempts; attempt++) {
+        u16 prev2 = boundary;
+        u16 prev1 = boundary;
+        int length = 0;
+        bool ended = false;
+        bytes = 0;
+        if (first != boundary && out_size > 4) {
+            bytes += lnUTF8Encode(out, m_alphabet[first]);
+            length++;
+            prev1 = first;
+        }
+
+        while (length < m_max_length) {
+            const int allow_end = length >= m_min_length;
+            const Alias_table* table = &m_order2_tables[(prev2*n + prev1)*2 + allow_end];
+            if (table->size == 0) table = &m_order1_tables[prev1*2 + allow_end];
+            if (table->size == 0) table = &m_order0_tables[allow_end];
+
+            const u16 symbol = sample(*table);
+            if (symbol == boundary) {
+                ended = true;
+                break;
+            }
+            // leave room for the longest encoding and the null terminator
+            if (bytes + 4 >= out_size) break;
+
+            bytes += lnUTF8Encode(out + bytes, m_alphabet[symbol]);
+            length++;
+            prev2 = prev1;
+            prev1 = symbol;
+        }
+
+        if (ended) break;
+    }
+
+    out[bytes] = 0;
+    return bytes;
+}
+
+u16 Pseudo_word_generator::symbol_of(u32 codepoint) const
+{
+    for (size_t i = 1; i < m_alphabet.size(); i++) {
+        if (m_alphabet[i] == codepoint) return static_cast<u16>(i);
+    }
+    return boundary;
+}
+
+Pseudo_word_generator::Alias_table
+Pseudo_word_generator::build_table(const u32* counts, bool allow_end)
+{
+    Alias_table table{static_cast<u32>(m_prob.size()), 0};
+    u64 total = 0;
+    for (size_t symbol = 0; symbol < m_alphabet.size(); symbol++) {
+        const bool allowed = symbol == boundary ? allow_end : m_allowed[symbol];
+        if (!allowed || counts[symbol] == 0) continue;
+        m_symbol.push_back(static_cast<u16>(symbol));
+        total += counts[symbol];
+        table.size++;
+    }
+    if (table.size == 0) return table;
+
+    // Vose's alias method
+    m_prob.resize(table.offset + table.size);
+    m_alias.resize(table.offset + table.size);
+    float* prob = &m_prob[table.offset];
+    u16* alias = &m_alias[table.offset];
+    const u16* symbols = &m_symbol[table.offset];
+
+    std::vector<u16> small{};
+    std::vector<u16> large{};
+    for (u32 i = 0; i < table.size; i++) {
+        prob[i] = static_cast<float>(counts[symbols[i]]) * table.size / total;
+        if (prob[i] < 1.0f) small.push_back(static_cast<u16>(i));
+        else large.push_back(static_cast<u16>(i));
+    }
+    while (!small.empty() && !large.empty()) {
+        const u16 less = small.back();
+        small.pop_back();
+        const u16 more = large.back();
+        large.pop_back();
+
+        alias[less] = more;
+        prob[more] = prob[more] + prob[less] - 1.0f;
+        if (prob[more] < 1.0f) small.push_back(more);
+        else large.push_back(more);
+    }
+    // leftovers are 1 up to rounding errors
+    for (const u16 i : large) { prob[i] = 1.0f; alias[i] = i; }
+    for (const u16 i : small) { prob[i] = 1.0f; alias[i] = i; }
+
+    return table;
+}
+
+u16 Pseudo_word_generator::sample(const Alias_table& table)
+{
+    std::uniform_int_distribution<u32> column_dist{0, table.size - 1};
+    const u32 i = table.offset + column_dist(m_re);
+    return m_coin(m_re) < m_prob[i] ? m_symbol[i] : m_symbol[table.offset + m_alias[i]];
+}
+
+}
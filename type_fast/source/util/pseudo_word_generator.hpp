@@ -0,0 +1,151 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __PSEUDO_WORD_GENERATOR_HPP__
+#define __PSEUDO_WORD_GENERATOR_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <vector>
+#include <string>
+#include <random>
+#include "types.hpp"
+
+// ============================================================ //
+// Class
+// ============================================================ //
+
+namespace tf
+{
+
+/**
+ * Character level markov chain (order 2, backing off to order 1 and 0) that
+ * generates pronounceable pseudo-words. Used for letter drills, where only a
+ * handful of letters are unlocked and the dictionary has too few words made
+ * from them.
+ *
+ * Usage:
+ * 1. train() on a list of words.
+ * 2. set_allowed() with the unlocked letters, builds the alias tables.
+ * 3. next() as often as you like, it does not allocate.
+ */
+class Pseudo_word_generator
+{
+public:
+    Pseudo_word_generator() = default;
+
+    Pseudo_word_generator(const Pseudo_word_generator& other) = delete;
+    Pseudo_word_generator& operator=(const Pseudo_word_generator& other) = delete;
+
+    /**
+     * Count the letter transitions in @words. Words are expected to be UTF-8,
+     * and already lowercase if that is wanted.
+     */
+    void train(const std::vector<std::string>& words);
+
+    /**
+     * Restrict generation to @letters and rebuild the alias tables. Call when
+     * the letter set changes, not per word.
+     * @param letters Null terminated UTF-8 string, each codepoint is a letter.
+     * @param min_length Minimum word length in codepoints.
+     * @param max_length Maximum word length in codepoints.
+     * @return If any of the letters exist in the trained alphabet.
+     */
+    bool set_allowed(const char* letters, int min_length, int max_length);
+
+    /**
+     * Write a null terminated pseudo-word into @out.
+     * @return Bytes written, excluding the null terminator.
+     */
+    int next(char* out, int out_size);
+
+    /**
+     * Like next, but the word begins with @codepoint if it's an allowed
+     * letter.
+     */
+    int next_starting_with(u32 codepoint, char* out, int out_size);
+
+    bool is_ready() const { return m_ready; }
+
+    void seed(u32 seed) { m_re.seed(seed); }
+
+    size_t alphabet_size() const { return m_alphabet.size(); }
+
+private:
+    /**
+     * A Vose alias table, its entries lives in m_prob, m_alias and m_symbol.
+     */
+    struct Alias_table
+    {
+        u32 offset;
+        u32 size;
+    };
+
+    u16 symbol_of(u32 codepoint) const;
+
+    /**
+     * @param first Symbol the word begins with, boundary for any.
+     */
+    int generate(u16 first, char* out, int out_size);
+
+    Alias_table build_table(const u32* counts, bool allow_end);
+
+    u16 sample(const Alias_table& table);
+
+private:
+    // symbol 0 is the word boundary, the rest maps to a codepoint
+    static constexpr u16 boundary = 0;
+    static constexpr size_t max_symbols = 64;
+    // how many times to try for a word that ends on its own before
+    // accepting one that was cut at max length
+    static constexpr int max_attempts = 4;
+
+    std::vector<u32> m_alphabet;
+    std::vector<u32> m_bigram_counts;  // [prev][next]
+    std::vector<u32> m_trigram_counts; // [prev2][prev][next]
+    std::vector<bool> m_allowed;
+
+    // two tables per context, [without end, with end]
+    std::vector<Alias_table> m_order2_tables;
+    std::vector<Alias_table> m_order1_tables;
+    Alias_table m_order0_tables[2]{};
+
+    std::vector<float> m_prob;
+    std::vector<u16> m_alias;
+    std::vector<u16> m_symbol;
+
+    int m_min_length = 0;
+    int m_max_length = 0;
+    bool m_ready = false;
+
+    std::random_device m_rd{};
+    std::default_random_engine m_re{m_rd()};
+    std::uniform_real_distribution<float> m_coin{0.0f, 1.0f};
+};
+
+}
+
+#endif//__PSEUDO_WORD_GENERATOR_HPP__
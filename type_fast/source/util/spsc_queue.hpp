@@ -0,0 +1,101 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __SPSC_QUEUE_HPP__
+#define __SPSC_QUEUE_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+// ============================================================ //
+// Class
+// ============================================================ //
+
+namespace tf
+{
+
+/**
+ * Lock-free bounded queue for exactly one producer thread and one consumer
+ * thread. The read and write positions live on separate cache lines so the
+ * two threads don't fight over them.
+ *
+ * @TCapacity must be a power of two.
+ */
+template <typename T, size_t TCapacity>
+class Spsc_queue
+{
+    static_assert((TCapacity & (TCapacity - 1)) == 0, "capacity is a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "T is trivially copyable");
+
+public:
+    /**
+     * Producer only.
+     * @return If @item fit, else the queue is full and it was dropped.
+     */
+    bool push(const T& item)
+        {
+            const size_t write = m_write.load(std::memory_order_relaxed);
+            if (write - m_read.load(std::memory_order_acquire) == TCapacity) {
+                return false;
+            }
+            m_items[write & (TCapacity - 1)] = item;
+            m_write.store(write + 1, std::memory_order_release);
+            return true;
+        }
+
+    /**
+     * Consumer only.
+     * @return If an item was written to @item.
+     */
+    bool pop(T& item)
+        {
+            const size_t read = m_read.load(std::memory_order_relaxed);
+            if (read == m_write.load(std::memory_order_acquire)) {
+                return false;
+            }
+            item = m_items[read & (TCapacity - 1)];
+            m_read.store(read + 1, std::memory_order_release);
+            return true;
+        }
+
+    bool empty() const
+        {
+            return m_read.load(std::memory_order_acquire) ==
+                m_write.load(std::memory_order_acquire);
+        }
+
+private:
+    alignas(64) std::atomic<size_t> m_write{0};
+    alignas(64) std::atomic<size_t> m_read{0};
+    alignas(64) T m_items[TCapacity];
+};
+
+}
+
+#endif//__SPSC_QUEUE_HPP__
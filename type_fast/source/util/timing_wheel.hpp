@@ -0,0 +1,289 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __TIMING_WHEEL_HPP__
+#define __TIMING_WHEEL_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <cstddef>
+#include <vector>
+#include "types.hpp"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// ============================================================ //
+// Class
+// ============================================================ //
+
+namespace tf
+{
+
+/**
+ * Refers to a scheduled timer, stays safe to use after the timer fired.
+ */
+struct Timer_handle
+{
+    u32 index = 0;
+    u32 generation = 0; // 0 is never scheduled
+};
+
+/**
+ * Hierarchical timing wheel. Timers go in one of 64 slots of 1 ms on the
+ * first level, or on the coarser levels above it when they are further
+ * away, and move down a level each time the level below wraps around.
+ * Scheduling and cancelling are O(1), and advancing skips empty slots.
+ *
+ * Timers never fire early. When advance covers several deadlines, they all
+ * fire in order with the time they were due, so the caller can catch up.
+ * A timer scheduled while advancing, at or before the time advanced to,
+ * fires in the same advance.
+ *
+ * Usage:
+ *   wheel.schedule(now + 500000, Timer{spawn});
+ *   wheel.advance(now, [](const Timer& timer, u64 deadline_us) { ... });
+ */
+template <typename T>
+class Timing_wheel
+{
+public:
+    static constexpr u64 resolution_us = 1000;
+    static constexpr int slot_bits = 6;
+    static constexpr int slot_count = 1 << slot_bits;
+    // 64^4 ms is about 4.6 hours, anything further waits in an overflow list
+    static constexpr int level_count = 4;
+
+    explicit Timing_wheel(u64 time_us = 0) { reset(time_us); }
+
+    /**
+     * Drop every timer and start over at @time_us.
+     */
+    void reset(u64 time_us)
+        {
+            m_nodes.clear();
+            m_free = none;
+            for (u32& head : m_heads) head = none;
+            for (u64& occupied : m_occupied) occupied = 0;
+            m_now = time_us / resolution_us;
+            m_size = 0;
+        }
+
+    Timer_handle schedule(u64 deadline_us, const T& payload)
+        {
+            u32 index = m_free;
+            if (index != none) m_free = m_nodes[index].next;
+            else {
+                index = static_cast<u32>(m_nodes.size());
+                m_nodes.push_back({});
+            }
+            Node& node = m_nodes[index];
+            node.deadline_us = deadline_us;
+            node.payload = payload;
+            node.generation++;
+            place(index);
+            m_size++;
+            return {index, node.generation};
+        }
+
+    /**
+     * @return If the timer was still scheduled. @handle is cleared either way.
+     */
+    bool cancel(Timer_handle& handle)
+        {
+            const bool scheduled = is_scheduled(handle);
+            if (scheduled) {
+                unlink(handle.index);
+                release(handle.index);
+            }
+            handle = {};
+            return scheduled;
+        }
+
+    bool is_scheduled(const Timer_handle& handle) const
+        {
+            return handle.generation != 0 && handle.index < m_nodes.size() &&
+                m_nodes[handle.index].generation == handle.generation &&
+                m_nodes[handle.index].slot != none;
+        }
+
+    /**
+     * Fire every timer due at or before @time_us as fn(payload, deadline_us),
+     * in deadline order down to the ms.
+     */
+    template <typename TFn>
+    void advance(u64 time_us, TFn&& fn)
+        {
+            const u64 target = time_us / resolution_us;
+            while (m_now <= target) {
+                if (m_size == 0) {
+                    m_now = target + 1;
+                    break;
+                }
+                if ((m_now & (slot_count - 1)) == 0) cascade();
+
+                const u32 slot = static_cast<u32>(m_now & (slot_count - 1));
+                while (m_heads[slot] != none) {
+                    const u32 index = m_heads[slot];
+                    unlink(index);
+                    // copied, fn may schedule and move the nodes
+                    const T payload = m_nodes[index].payload;
+                    const u64 deadline_us = m_nodes[index].deadline_us;
+                    release(index);
+                    fn(payload, deadline_us);
+                }
+
+                // next occupied slot in this block, or the start of the next
+                const u64 above = slot + 1 < slot_count ? ~0ull << (slot + 1) : 0;
+                const u64 occupied = m_occupied[0] & above;
+                const u64 next = occupied != 0
+                    ? (m_now & ~u64(slot_count - 1)) + count_trailing_zeros(occupied)
+                    : (m_now | (slot_count - 1)) + 1;
+                m_now = next < target + 1 ? next : target + 1;
+            }
+        }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+private:
+    static constexpr u32 none = 0xFFFFFFFF;
+    static constexpr u32 overflow_slot = level_count * slot_count;
+
+    struct Node
+    {
+        u64 deadline_us = 0;
+        T payload{};
+        u32 prev = none;
+        u32 next = none;
+        u32 generation = 0;
+        u32 slot = none;
+    };
+
+    static int count_trailing_zeros(u64 mask)
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward64(&index, mask);
+            return static_cast<int>(index);
+#else
+            return __builtin_ctzll(mask);
+#endif
+        }
+
+    /**
+     * Put a node in the slot for its deadline, relative to m_now.
+     */
+    void place(u32 index)
+        {
+            const u64 deadline_us = m_nodes[index].deadline_us;
+            u64 tick = (deadline_us + resolution_us - 1) / resolution_us;
+            if (tick < m_now) tick = m_now;
+
+            for (int level = 0; level < level_count; level++) {
+                const int shift = level * slot_bits;
+                // same block of this level as now, else it goes further up
+                if ((tick >> (shift + slot_bits)) == (m_now >> (shift + slot_bits))) {
+                    const u32 slot = static_cast<u32>((tick >> shift) & (slot_count - 1));
+                    link(index, level * slot_count + slot);
+                    return;
+                }
+            }
+            link(index, overflow_slot);
+        }
+
+    /**
+     * m_now is at the start of a first level block, move the timers of the
+     * slots that begin here down.
+     */
+    void cascade()
+        {
+            constexpr u64 overflow_block = 1ull << (level_count * slot_bits);
+            if ((m_now & (overflow_block - 1)) == 0) replace(overflow_slot);
+            for (int level = level_count - 1; level > 0; level--) {
+                const u64 block = 1ull << (level * slot_bits);
+                if ((m_now & (block - 1)) != 0) continue;
+                const u32 slot = static_cast<u32>((m_now >> (level * slot_bits)) & (slot_count - 1));
+                replace(level * slot_count + slot);
+            }
+        }
+
+    void replace(u32 slot)
+        {
+            u32 index = m_heads[slot];
+            while (index != none) {
+                const u32 next = m_nodes[index].next;
+                unlink(index);
+                place(index);
+                index = next;
+            }
+        }
+
+    void link(u32 index, u32 slot)
+        {
+            Node& node = m_nodes[index];
+            node.slot = slot;
+            node.prev = none;
+            node.next = m_heads[slot];
+            if (node.next != none) m_nodes[node.next].prev = index;
+            m_heads[slot] = index;
+            if (slot != overflow_slot) {
+                m_occupied[slot / slot_count] |= 1ull << (slot % slot_count);
+            }
+        }
+
+    void unlink(u32 index)
+        {
+            Node& node = m_nodes[index];
+            if (node.prev != none) m_nodes[node.prev].next = node.next;
+            else m_heads[node.slot] = node.next;
+            if (node.next != none) m_nodes[node.next].prev = node.prev;
+            if (m_heads[node.slot] == none && node.slot != overflow_slot) {
+                m_occupied[node.slot / slot_count] &= ~(1ull << (node.slot % slot_count));
+            }
+            node.slot = none;
+        }
+
+    void release(u32 index)
+        {
+            m_nodes[index].next = m_free;
+            m_free = index;
+            m_size--;
+        }
+
+    std::vector<Node> m_nodes;
+    u32 m_free = none;
+    u32 m_heads[level_count * slot_count + 1];
+    u64 m_occupied[level_count];
+    // the next tick to fire
+    u64 m_now = 0;
+    size_t m_size = 0;
+};
+
+}
+
+#endif//__TIMING_WHEEL_HPP__
@@ -0,0 +1,243 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "typing_cost.hpp"
+
+#include <cmath>
+#include <cctype>
+#include <thread>
+
+namespace tf
+{
+
+// ============================================================ //
+// Layouts
+// ============================================================ //
+
+constexpr int layout_rows = 3;
+constexpr int layout_cols = 10;
+
+static const char* const qwerty_rows[layout_rows] = {
+    "qwertyuiop",
+    "asdfghjkl;",
+    "zxcvbnm,./"
+};
+static const char* const dvorak_rows[layout_rows] = {
+    "',.pyfgcrl",
+    "aoeuidhtns",
+    ";qjkxbmwvz"
+};
+static const char* const colemak_rows[layout_rows] = {
+    "qwfpgjluy;",
+    "arstdhneio",
+    "zxcvbkm,./"
+};
+
+// fingers are numbered left pinky 0 to right pinky 7
+constexpr int col_finger[layout_cols] = {0, 1, 2, 3, 3, 4, 4, 5, 6, 7};
+constexpr int finger_home_col[8] = {0, 1, 2, 3, 6, 7, 8, 9};
+constexpr float finger_effort[8] = {1.6f, 1.3f, 1.0f, 1.0f, 1.0f, 1.0f, 1.3f, 1.6f};
+// horizontal offset of each row, relative to the home row
+constexpr float row_stagger[layout_rows] = {-0.25f, 0.0f, 0.5f};
+constexpr int home_row = 1;
+
+// cost weights
+constexpr float travel_weight = 0.5f;
+constexpr float shift_cost = 1.0f;
+constexpr float unknown_cost = 2.0f;
+constexpr float same_finger_cost = 2.0f;
+constexpr float same_hand_cost = 0.5f;
+constexpr float alternate_hand_cost = 0.0f;
+
+const char* keyboard_layout_to_string(Keyboard_layout layout)
+{
+    switch (layout) {
+    case Keyboard_layout::qwerty: return "QWERTY";
+    case Keyboard_layout::dvorak: return "Dvorak";
+    case Keyboard_layout::colemak: return "Colemak";
+    }
+    return "UNKNOWN_LAYOUT";
+}
+
+bool keyboard_layout_from_string(const char* name, Keyboard_layout& layout)
+{
+    constexpr Keyboard_layout layouts[] = {
+        Keyboard_layout::qwerty, Keyboard_layout::dvorak, Keyboard_layout::colemak
+    };
+    for (const Keyboard_layout candidate : layouts) {
+        const char* other = keyboard_layout_to_string(candidate);
+        size_t i = 0;
+        while (name[i] != 0 && std::tolower(static_cast<unsigned char>(name[i])) ==
+               std::tolower(static_cast<unsigned char>(other[i]))) {
+            i++;
+        }
+        if (name[i] == 0 && other[i] == 0) {
+            layout = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+static const char* const* rows_of(Keyboard_layout layout)
+{
+    switch (layout) {
+    case Keyboard_layout::qwerty: return qwerty_rows;
+    case Keyboard_layout::dvorak: return dvorak_rows;
+    case Keyboard_layout::colemak: return colemak_rows;
+    }
+    return qwerty_rows;
+}
+
+struct Key_info
+{
+    bool known;
+    bool shifted;
+    int finger;
+    float x;
+    float y;
+};
+
+static inline int hand_of(int finger) { return finger < 4 ? 0 : 1; }
+
+static inline float distance(float ax, float ay, float bx, float by)
+{
+    return std::sqrt((ax - bx) * (ax - bx) + (ay - by) * (ay - by));
+}
+
+// ============================================================ //
+// Typing_cost
+// ============================================================ //
+
+Typing_cost::Typing_cost(Keyboard_layout layout)
+{
+    set_layout(layout);
+}
+
+void Typing_cost::set_layout(Keyboard_layout layout)
+{
+    m_layout = layout;
+    Key_info info[keys]{};
+    const char* const* rows = rows_of(layout);
+    for (int row = 0; row < layout_rows; row++) {
+        for (int col = 0; col < layout_cols; col++) {
+            const u8 key = static_cast<u8>(rows[row][col]);
+            const Key_info key_info{
+                true, false, col_finger[col],
+                col + row_stagger[row], static_cast<float>(row - home_row)
+            };
+            info[key] = key_info;
+            if (std::isalpha(key)) {
+                info[std::toupper(key)] = key_info;
+                info[std::toupper(key)].shifted = true;
+            }
+        }
+    }
+
+    for (int key = 0; key < keys; key++) {
+        const Key_info& k = info[key];
+        if (!k.known) {
+            m_key_cost[key] = unknown_cost;
+            continue;
+        }
+        const float home_x = static_cast<float>(finger_home_col[k.finger]);
+        m_key_cost[key] = finger_effort[k.finger] +
+            travel_weight * distance(k.x, k.y, home_x, 0.0f) +
+            (k.shifted ? shift_cost : 0.0f);
+    }
+    m_key_cost[unknown_key] = unknown_cost;
+
+    for (int a = 0; a < keys; a++) {
+        for (int b = 0; b < keys; b++) {
+            const Key_info& ka = info[a];
+            const Key_info& kb = info[b];
+            float cost = 0.0f;
+            if (!ka.known || !kb.known || (ka.x == kb.x && ka.y == kb.y)) {
+                cost = 0.0f;
+            }
+            else if (ka.finger == kb.finger) {
+                cost = same_finger_cost + travel_weight * distance(ka.x, ka.y, kb.x, kb.y);
+            }
+            else if (hand_of(ka.finger) == hand_of(kb.finger)) {
+                cost = same_hand_cost;
+            }
+            else {
+                cost = alternate_hand_cost;
+            }
+            m_bigram_cost[a][b] = cost;
+        }
+    }
+}
+
+float Typing_cost::word_cost(const char* word, size_t bytes) const
+{
+    float cost = 0.0f;
+    u8 prev = unknown_key; // bigrams from the unknown key are free
+    for (size_t i = 0; i < bytes; i++) {
+        const u8 byte = static_cast<u8>(word[i]);
+        if ((byte & 0xC0) == 0x80) continue; // UTF-8 continuation byte
+        const u8 key = byte < keys ? byte : unknown_key;
+        cost += m_key_cost[key] + m_bigram_cost[prev][key];
+        prev = key;
+    }
+    return cost;
+}
+
+void Typing_cost::batch(const std::vector<std::string>& words,
+                        std::vector<float>& costs) const
+{
+    costs.resize(words.size());
+
+    const auto cost_range = [this, &words, &costs](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            costs[i] = word_cost(words[i].c_str(), words[i].size());
+        }
+    };
+
+    // not worth spinning up threads for small dictionaries
+    constexpr size_t min_words_per_thread = 4096;
+    const size_t hw_threads = std::thread::hardware_concurrency();
+    size_t threads = words.size() / min_words_per_thread;
+    if (threads > hw_threads) threads = hw_threads;
+    if (threads <= 1) {
+        cost_range(0, words.size());
+        return;
+    }
+
+    const size_t chunk = (words.size() + threads - 1) / threads;
+    std::vector<std::thread> workers{};
+    workers.reserve(threads - 1);
+    for (size_t t = 1; t < threads; t++) {
+        const size_t begin = t * chunk;
+        const size_t end = begin + chunk < words.size() ? begin + chunk : words.size();
+        if (begin >= end) break;
+        workers.emplace_back(cost_range, begin, end);
+    }
+    cost_range(0, chunk < words.size() ? chunk : words.size());
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+}
@@ -0,0 +1,100 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __TYPING_COST_HPP__
+#define __TYPING_COST_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <vector>
+#include <string>
+#include "types.hpp"
+
+// ============================================================ //
+// Class
+// ============================================================ //
+
+namespace tf
+{
+
+enum class Keyboard_layout : int
+{
+    qwerty = 0,
+    dvorak,
+    colemak
+};
+
+const char* keyboard_layout_to_string(Keyboard_layout layout);
+
+/**
+ * Parse a layout name, case insensitive.
+ * @return If @name is a layout.
+ */
+bool keyboard_layout_from_string(const char* name, Keyboard_layout& layout);
+
+/**
+ * Estimates how hard a word is to type on a keyboard layout, from finger
+ * travel, same finger bigrams and hand alternation.
+ *
+ * Everything is folded into a key cost table and a bigram cost table when the
+ * model is created, so costing a word is only table lookups.
+ */
+class Typing_cost
+{
+public:
+    explicit Typing_cost(Keyboard_layout layout = Keyboard_layout::qwerty);
+
+    /**
+     * Rebuild the cost tables for @layout in place.
+     */
+    void set_layout(Keyboard_layout layout);
+
+    /**
+     * @param word UTF-8 string, codepoints outside of ASCII get a fixed cost.
+     * @param bytes Size of the word in bytes.
+     */
+    float word_cost(const char* word, size_t bytes) const;
+
+    /**
+     * Cost every word in @words into @costs, split over all hardware threads.
+     */
+    void batch(const std::vector<std::string>& words, std::vector<float>& costs) const;
+
+    Keyboard_layout get_layout() const { return m_layout; }
+
+private:
+    static constexpr int keys = 128;
+    // non ASCII characters are costed as this key
+    static constexpr u8 unknown_key = 0;
+
+    Keyboard_layout m_layout;
+    float m_key_cost[keys];
+    float m_bigram_cost[keys][keys];
+};
+
+}
+
+#endif//__TYPING_COST_HPP__
@@ -0,0 +1,226 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "utf8_simd.hpp"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#define TF_UTF8_SSE2
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#define TF_UTF8_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace tf
+{
+
+// ============================================================ //
+// Bit helpers
+// ============================================================ //
+
+static inline int count_trailing_zeros(u32 mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+static inline int count_bits(u32 mask)
+{
+    mask = mask - ((mask >> 1) & 0x55555555u);
+    mask = (mask & 0x33333333u) + ((mask >> 2) & 0x33333333u);
+    return static_cast<int>((((mask + (mask >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+}
+
+static inline bool is_continuation(char byte)
+{
+    return (static_cast<u8>(byte) & 0xC0) == 0x80;
+}
+
+// ============================================================ //
+// Kernels
+// ============================================================ //
+
+/**
+ * @return Bytes from the start where @key and @input first differ, or where
+ * @key ends.
+ */
+static inline int common_bytes(const char* key, const char* input, int size)
+{
+    int pos = 0;
+
+#if defined(TF_UTF8_AVX2)
+    const __m256i zero32 = _mm256_setzero_si256();
+    for (; pos + 32 <= size; pos += 32) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key + pos));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + pos));
+        const u32 equal = static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+        const u32 end = static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, zero32)));
+        const u32 stop = ~equal | end;
+        if (stop != 0) return pos + count_trailing_zeros(stop);
+    }
+#endif
+
+#if defined(TF_UTF8_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; pos + 16 <= size; pos += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key + pos));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + pos));
+        const u32 equal = static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+        const u32 end = static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, zero)));
+        const u32 stop = (~equal | end) & 0xFFFF;
+        if (stop != 0) return pos + count_trailing_zeros(stop);
+    }
+#endif
+
+    while (pos < size && key[pos] != 0 && key[pos] == input[pos]) pos++;
+    return pos;
+}
+
+/**
+ * Decode the codepoint at the start of @text, without reading past @remaining.
+ * @return Bytes used.
+ */
+static inline size_t decode_one(const u8* text, size_t remaining, u32* codepoint)
+{
+    const u32 first = text[0];
+    if (first < 0x80) {
+        *codepoint = first;
+        return 1;
+    }
+    if ((first & 0xE0) == 0xC0 && remaining >= 2 && is_continuation(text[1])) {
+        *codepoint = ((first & 0x1F) << 6) | (text[1] & 0x3F);
+        return 2;
+    }
+    if ((first & 0xF0) == 0xE0 && remaining >= 3 &&
+        is_continuation(text[1]) && is_continuation(text[2])) {
+        *codepoint = ((first & 0x0F) << 12) | ((text[1] & 0x3F) << 6) | (text[2] & 0x3F);
+        return 3;
+    }
+    if ((first & 0xF8) == 0xF0 && remaining >= 4 && is_continuation(text[1]) &&
+        is_continuation(text[2]) && is_continuation(text[3])) {
+        *codepoint = ((first & 0x07) << 18) | ((text[1] & 0x3F) << 12) |
+            ((text[2] & 0x3F) << 6) | (text[3] & 0x3F);
+        return 4;
+    }
+    *codepoint = 0xFFFD; // replacement character
+    return 1;
+}
+
+// ============================================================ //
+
+int utf8_common_prefix(const char* key, const char* input, int size)
+{
+    int bytes = common_bytes(key, input, size);
+
+    // back off to the start of a codepoint that only matched partially, in
+    // either string, so a cut sequence in one does not match a whole one
+    while (bytes > 0 && bytes < size &&
+           (is_continuation(key[bytes]) || is_continuation(input[bytes]))) {
+        bytes--;
+    }
+
+    return static_cast<int>(utf8_count_codepoints(key, bytes));
+}
+
+size_t utf8_count_codepoints(const char* text, size_t bytes)
+{
+    size_t count = 0;
+    size_t pos = 0;
+
+    // continuation bytes are 0x80 to 0xBF, which is below -64 as signed
+#if defined(TF_UTF8_AVX2)
+    const __m256i continuation32 = _mm256_set1_epi8(-64);
+    for (; pos + 32 <= bytes; pos += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + pos));
+        const u32 cont = static_cast<u32>(
+            _mm256_movemask_epi8(_mm256_cmpgt_epi8(continuation32, chunk)));
+        count += 32 - count_bits(cont);
+    }
+#endif
+
+#if defined(TF_UTF8_SSE2)
+    const __m128i continuation = _mm_set1_epi8(-64);
+    for (; pos + 16 <= bytes; pos += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + pos));
+        const u32 cont = static_cast<u32>(
+            _mm_movemask_epi8(_mm_cmplt_epi8(chunk, continuation)));
+        count += 16 - count_bits(cont);
+    }
+#endif
+
+    for (; pos < bytes; pos++) {
+        count += !is_continuation(text[pos]);
+    }
+    return count;
+}
+
+size_t utf8_to_utf32(const char* text, size_t bytes, u32* out)
+{
+    const u8* data = reinterpret_cast<const u8*>(text);
+    size_t count = 0;
+    size_t pos = 0;
+
+    while (pos < bytes) {
+#if defined(TF_UTF8_SSE2)
+        if (pos + 16 <= bytes) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            const u32 non_ascii = static_cast<u32>(_mm_movemask_epi8(chunk));
+            if (non_ascii == 0) { // widen 16 ASCII bytes to 16 codepoints
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i lo16 = _mm_unpacklo_epi8(chunk, zero);
+                const __m128i hi16 = _mm_unpackhi_epi8(chunk, zero);
+                __m128i* dst = reinterpret_cast<__m128i*>(out + count);
+                _mm_storeu_si128(dst + 0, _mm_unpacklo_epi16(lo16, zero));
+                _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(lo16, zero));
+                _mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(hi16, zero));
+                _mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(hi16, zero));
+                pos += 16;
+                count += 16;
+                continue;
+            }
+            // copy the ASCII leading up to the first multibyte codepoint
+            const int ascii = count_trailing_zeros(non_ascii);
+            for (int i = 0; i < ascii; i++) {
+                out[count++] = data[pos++];
+            }
+        }
+#endif
+        pos += decode_one(data + pos, bytes - pos, &out[count]);
+        count++;
+    }
+
+    return count;
+}
+
+}
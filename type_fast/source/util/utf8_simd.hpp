@@ -0,0 +1,71 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __UTF8_SIMD_HPP__
+#define __UTF8_SIMD_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <cstddef>
+#include "types.hpp"
+
+// ============================================================ //
+// Functions
+// ============================================================ //
+
+namespace tf
+{
+
+/**
+ * Count how many codepoints @key and @input have in common from the start.
+ * Compares 16 (or 32 with AVX2) bytes at a time, then backs off to the last
+ * whole codepoint and counts the bytes that are not UTF-8 continuation bytes.
+ *
+ * @param key Null terminated UTF-8 string, the matching ends at its end.
+ * @param input UTF-8 string.
+ * @param size Both buffers must be readable for @size bytes.
+ */
+int utf8_common_prefix(const char* key, const char* input, int size);
+
+/**
+ * Count the codepoints in @bytes of UTF-8, by counting the bytes that are not
+ * continuation bytes, 16 or 32 at a time.
+ */
+size_t utf8_count_codepoints(const char* text, size_t bytes);
+
+/**
+ * Decode @bytes of UTF-8 into codepoints. Runs of ASCII are widened 16 bytes
+ * at a time, the rest is decoded one codepoint at a time. Invalid or cut
+ * sequences are decoded as U+FFFD.
+ *
+ * @param out Room for @bytes codepoints, the most @text can decode to.
+ * @return Number of codepoints written to @out.
+ */
+size_t utf8_to_utf32(const char* text, size_t bytes, u32* out);
+
+}
+
+#endif//__UTF8_SIMD_HPP__
@@ -25,10 +25,30 @@
 #include "word_generator.hpp"
 
 #include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <numeric>
+#include "util.hpp"
 
 namespace tf
 {
 
+static inline u32 first_codepoint(const std::string& word)
+{
+    if (word.empty()) return 0;
+    u64 codepoint;
+    u32 bytes;
+    if (!lnUTF8Decode(word.c_str(), 0, &codepoint, &bytes)) return 0;
+    return static_cast<u32>(codepoint);
+}
+
+static inline void copy_word(const std::string& word, char* out, size_t out_size)
+{
+    const size_t bytes = word.size() < out_size ? word.size() : out_size - 1;
+    std::memcpy(out, word.c_str(), bytes);
+    out[bytes] = 0;
+}
+
 Word_generator::Word_generator(const File& file, const DelimSettings& settings)
 {
     load(file, settings);
@@ -53,14 +73,173 @@ void Word_generator::load(const File& file, const DelimSettings& settings)
         offset = end + 1;
     }
 
+    m_typing_cost.batch(m_strlist, m_costs);
+    sort_by_cost();
+    build_chain_index();
+
+    m_pseudo.train(m_strlist);
+    m_letter_drill = false;
+}
+
+std::string Word_generator::next()
+{
+    if (m_letter_drill) {
+        char buf[64];
+        m_pseudo.next(buf, sizeof(buf));
+        return buf;
+    }
+    return m_strlist[m_by_cost[m_dist(m_re)]];
+}
+
+void Word_generator::next(char* out, size_t out_size)
+{
+    if (out_size == 0) return;
+    if (m_letter_drill) {
+        m_pseudo.next(out, static_cast<int>(out_size));
+        return;
+    }
+    copy_word(m_strlist[m_by_cost[m_dist(m_re)]], out, out_size);
+}
+
+bool Word_generator::set_letter_drill(const char* letters, int min_length,
+                                      int max_length)
+{
+    m_letter_drill = m_pseudo.set_allowed(letters, min_length, max_length);
+    return m_letter_drill;
+}
+
+void Word_generator::set_layout(Keyboard_layout layout)
+{
+    m_typing_cost.set_layout(layout);
+    m_typing_cost.batch(m_strlist, m_costs);
+    sort_by_cost();
+}
+
+void Word_generator::set_difficulty(float min, float max)
+{
+    m_difficulty_min = clamp(min, 0.0f, 1.0f);
+    m_difficulty_max = clamp(max, m_difficulty_min, 1.0f);
+    if (m_by_cost.empty()) return;
+
+    const long last = static_cast<long>(m_by_cost.size() - 1);
+    const long first = std::lround(m_difficulty_min * last);
     std::uniform_int_distribution<long>::param_type param{
-        0, static_cast<long>(m_strlist.size() - 1) };
+        first, std::max(first, std::lround(m_difficulty_max * last)) };
     m_dist.param(param);
 }
 
-std::string Word_generator::next()
+void Word_generator::sort_by_cost()
 {
-    return m_strlist[m_dist(m_re)];
+    m_by_cost.resize(m_strlist.size());
+    std::iota(m_by_cost.begin(), m_by_cost.end(), 0);
+    std::sort(m_by_cost.begin(), m_by_cost.end(), [this](u32 a, u32 b) {
+        return m_costs[a] < m_costs[b];
+    });
+    m_rank.resize(m_by_cost.size());
+    for (u32 rank = 0; rank < static_cast<u32>(m_by_cost.size()); rank++) {
+        m_rank[m_by_cost[rank]] = rank;
+    }
+    sort_chain_buckets();
+    set_difficulty(m_difficulty_min, m_difficulty_max);
+}
+
+void Word_generator::sort_chain_buckets()
+{
+    const auto by_rank = [this](u32 a, u32 b) { return m_rank[a] < m_rank[b]; };
+    // dead end letters share the fallback bucket, sorting it again is harmless
+    for (const auto& pair : m_first_index) {
+        const Letter_bucket& bucket = pair.second;
+        const auto begin = m_chain_words.begin() + bucket.offset;
+        std::sort(begin, begin + bucket.safe_size, by_rank);
+        std::sort(begin + bucket.safe_size, begin + bucket.size, by_rank);
+    }
+}
+
+bool Word_generator::pick_in_difficulty(const Letter_bucket& bucket, u32& word)
+{
+    const u32 first_rank = static_cast<u32>(m_dist.a());
+    const u32 last_rank = static_cast<u32>(m_dist.b());
+    const auto below = [this](u32 word, u32 rank) { return m_rank[word] < rank; };
+    const u32 parts[3] = { bucket.offset, bucket.offset + bucket.safe_size,
+                           bucket.offset + bucket.size };
+    for (int part = 0; part < 2; part++) {
+        const auto part_end = m_chain_words.begin() + parts[part + 1];
+        const auto first = std::lower_bound(m_chain_words.begin() + parts[part], part_end,
+                                            first_rank, below);
+        const auto last = std::lower_bound(first, part_end, last_rank + 1, below);
+        if (first == last) continue;
+        std::uniform_int_distribution<long> dist{0, static_cast<long>(last - first) - 1};
+        word = *(first + dist(m_re));
+        return true;
+    }
+    return false;
+}
+
+void Word_generator::next_starting_with(u32 codepoint, char* out, size_t out_size)
+{
+    if (out_size == 0) return;
+    if (m_letter_drill) {
+        m_pseudo.next_starting_with(codepoint, out, static_cast<int>(out_size));
+        return;
+    }
+    const auto it = m_first_index.find(codepoint);
+    const Letter_bucket& bucket = it != m_first_index.end() ? it->second : m_chain_fallback;
+    u32 word;
+    if (pick_in_difficulty(bucket, word) || pick_in_difficulty(m_chain_fallback, word)) {
+        copy_word(m_strlist[word], out, out_size);
+    }
+    else {
+        next(out, out_size);
+    }
+}
+
+u32 Word_generator::last_codepoint(const char* word)
+{
+    const int size = static_cast<int>(strlen(word));
+    if (size == 0) return 0;
+    const int bytes = lnUTF8Seek(word, size);
+    u64 codepoint;
+    u32 decoded;
+    if (!lnUTF8Decode(word, size - bytes, &codepoint, &decoded)) return 0;
+    return static_cast<u32>(codepoint);
+}
+
+void Word_generator::build_chain_index()
+{
+    std::unordered_map<u32, std::vector<u32>> by_first{};
+    for (u32 i = 0; i < static_cast<u32>(m_strlist.size()); i++) {
+        by_first[first_codepoint(m_strlist[i])].push_back(i);
+    }
+
+    m_first_index.clear();
+    m_chain_words.clear();
+    m_chain_words.reserve(m_strlist.size());
+    m_chain_fallback = Letter_bucket{0, 0, 0};
+    for (auto& pair : by_first) {
+        auto& words = pair.second;
+        // words that can be continued goes first
+        const auto safe_end = std::stable_partition(
+            words.begin(), words.end(), [this, &by_first](u32 i) {
+                return by_first.count(last_codepoint(m_strlist[i].c_str())) > 0;
+            });
+
+        Letter_bucket bucket{
+            static_cast<u32>(m_chain_words.size()), static_cast<u32>(words.size()),
+            static_cast<u32>(safe_end - words.begin())
+        };
+        m_chain_words.insert(m_chain_words.end(), words.begin(), words.end());
+        m_first_index[pair.first] = bucket;
+        if (bucket.size > m_chain_fallback.size) m_chain_fallback = bucket;
+    }
+
+    // dead ends, letters that words end with but no word begins with
+    for (const auto& word : m_strlist) {
+        const u32 last = last_codepoint(word.c_str());
+        if (m_first_index.find(last) == m_first_index.end()) {
+            m_first_index[last] = m_chain_fallback;
+        }
+    }
+    sort_chain_buckets();
 }
 
 }
@@ -31,7 +31,10 @@
 
 #include <vector>
 #include <random>
+#include <unordered_map>
 #include "file.hpp"
+#include "pseudo_word_generator.hpp"
+#include "typing_cost.hpp"
 #include "../thirdparty/filip/unicode.h"
 
 // ============================================================ //
@@ -64,10 +67,113 @@ public:
 
     std::string next();
 
+    /**
+     * Write the next word into @out, null terminated. Does not allocate.
+     */
+    void next(char* out, size_t out_size);
+
+    /**
+     * Generate pseudo-words made only from @letters, instead of picking from
+     * the dictionary. Useful when so few letters are unlocked that the
+     * dictionary runs dry.
+     * @param letters Null terminated UTF-8 string, each codepoint is a letter.
+     * @return If the drill could be started, else the dictionary is used.
+     */
+    bool set_letter_drill(const char* letters, int min_length, int max_length);
+
+    void clear_letter_drill() { m_letter_drill = false; }
+
+    bool is_letter_drill() const { return m_letter_drill; }
+
+    /**
+     * Recompute the typing cost of every word for @layout.
+     */
+    void set_layout(Keyboard_layout layout);
+
+    Keyboard_layout get_layout() const { return m_typing_cost.get_layout(); }
+
+    /**
+     * Only pick dictionary words within a range of typing cost.
+     * @param min Lower percentile, 0 is the easiest word.
+     * @param max Upper percentile, 1 is the hardest word.
+     */
+    void set_difficulty(float min, float max);
+
+    /**
+     * Write a word that begins with @codepoint into @out, null terminated.
+     * Prefers words whose last letter other words begin with, so a word chain
+     * does not run into a dead end. Keeps to the letter drill and the
+     * difficulty like next. If no word within the difficulty begins with
+     * @codepoint, a word from the most common first letter is used instead,
+     * or any word if that has none either.
+     */
+    void next_starting_with(u32 codepoint, char* out, size_t out_size);
+
+    /**
+     * @param word Null terminated UTF-8 string.
+     * @return Last codepoint of @word, or 0 if empty.
+     */
+    static u32 last_codepoint(const char* word);
+
     size_t word_count() const { return m_strlist.size(); }
 
+    /**
+     * Make the sequence of words reproducible.
+     */
+    void seed(u32 seed) { m_re.seed(seed); m_pseudo.seed(seed ^ 0x9E3779B9u); }
+
+private:
+    /**
+     * Bucket of words that begin with the same letter, it's words lives in
+     * m_chain_words[offset, offset + size). The first safe_size of them end
+     * with a letter that other words begin with.
+     */
+    struct Letter_bucket
+    {
+        u32 offset;
+        u32 size;
+        u32 safe_size;
+    };
+
+    /**
+     * Bucket words by their first codepoint, for next_starting_with().
+     */
+    void build_chain_index();
+
+    /**
+     * Sort m_by_cost by the current m_costs and reapply the difficulty.
+     */
+    void sort_by_cost();
+
+    /**
+     * Sort both parts of every bucket by m_rank, so the words within the
+     * difficulty are a range of each part.
+     */
+    void sort_chain_buckets();
+
+    /**
+     * Pick a word of @bucket within the difficulty, safe words first.
+     * @return If it had any.
+     */
+    bool pick_in_difficulty(const Letter_bucket& bucket, u32& word);
+
 private:
     std::vector<std::string> m_strlist;
+    // typing cost of each word in m_strlist
+    std::vector<float> m_costs;
+    // indices into m_strlist, from easiest to hardest
+    std::vector<u32> m_by_cost;
+    // position of each word of m_strlist in m_by_cost
+    std::vector<u32> m_rank;
+    Typing_cost m_typing_cost{};
+    float m_difficulty_min = 0.0f;
+    float m_difficulty_max = 1.0f;
+    // first codepoint -> words that begin with it
+    std::unordered_map<u32, Letter_bucket> m_first_index;
+    std::vector<u32> m_chain_words;
+    Letter_bucket m_chain_fallback{0, 0, 0};
+    Pseudo_word_generator m_pseudo{};
+    bool m_letter_drill = false;
     std::random_device m_rd{};
     std::default_random_engine m_re{m_rd()};
     std::uniform_int_distribution<long> m_dist;
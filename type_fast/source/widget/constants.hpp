@@ -29,7 +29,7 @@
 // Headers
 // ============================================================ //
 
-
+#include <cstddef>
 
 // ============================================================ //
 // Class
@@ -43,6 +43,8 @@ namespace constants
 
 constexpr int word_size = 40;
 constexpr int text_size = 256;
+// events that fit in one frame, see Event_buffer
+constexpr size_t max_frame_events = 256;
 
 }
 
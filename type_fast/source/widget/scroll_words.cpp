@@ -0,0 +1,289 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "scroll_words.hpp"
+
+#include <cstring>
+#include "../util/fold.hpp"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#define TF_SCROLL_SSE2
+#include <emmintrin.h>
+#if defined(__AVX__)
+#define TF_SCROLL_AVX
+#include <immintrin.h>
+#endif
+#endif
+
+namespace tf
+{
+
+// ============================================================ //
+// Scroll_words
+// ============================================================ //
+
+u32 Scroll_words::add(Font* font, const Word& word, Color highlight_color, float speed,
+                      bool fold)
+{
+    const u32 text_id = add_text(font, word, highlight_color, fold);
+    const u32 index = static_cast<u32>(m_words.size());
+    m_words.x.push_back(word.pos.x);
+    m_words.y.push_back(word.pos.y);
+    m_words.speed.push_back(speed);
+    m_words.width.push_back(m_words.texts[text_id].metrics.advances[
+                                m_words.texts[text_id].metrics.length]);
+    m_words.last_step.push_back(0);
+    m_words.highlight.push_back(m_text_highlight[text_id]);
+    m_words.text_id.push_back(text_id);
+    m_text_words[text_id].push_back(index);
+    return index;
+}
+
+u32 Scroll_words::add_text(Font* font, const Word& word, Color highlight_color, bool fold)
+{
+    char key[Word::text_size];
+    if (fold) fold_utf8(word.text, key, Word::text_size);
+    else memcpy(key, word.text, Word::text_size);
+
+    const auto range = m_lookup.equal_range(key);
+    for (auto it = range.first; it != range.second; it++) {
+        const Scroll_word_text& text = m_words.texts[it->second];
+        if (strcmp(text.text, word.text) == 0 && text.font_size == word.font_size) {
+            return it->second;
+        }
+    }
+
+    u32 text_id;
+    if (!m_free_texts.empty()) {
+        text_id = m_free_texts.back();
+        m_free_texts.pop_back();
+    }
+    else {
+        text_id = static_cast<u32>(m_words.texts.size());
+        m_words.texts.emplace_back();
+        m_text_words.emplace_back();
+        m_text_highlight.push_back(0);
+    }
+    Scroll_word_text& text = m_words.texts[text_id];
+    memcpy(text.text, word.text, Word::text_size);
+    memcpy(text.match_key, key, Word::text_size);
+    text.font_size = word.font_size;
+    text.color = word.color;
+    text.highlight_color = highlight_color;
+    measure_metrics(font, text.text, text.font_size, text.metrics);
+    m_words.texts_version++;
+    m_lookup.insert({std::string{key}, text_id});
+    m_text_highlight[text_id] = m_trie.insert(text_id, text.match_key);
+    return text_id;
+}
+
+void Scroll_words::remove(u32 index)
+{
+    // forget the word in its text, and the text when nothing shows it
+    const u32 text_id = m_words.text_id[index];
+    std::vector<u32>& text_words = m_text_words[text_id];
+    for (auto& word : text_words) {
+        if (word == index) {
+            word = text_words.back();
+            text_words.pop_back();
+            break;
+        }
+    }
+    if (text_words.empty()) {
+        const auto range = m_lookup.equal_range(m_words.texts[text_id].match_key);
+        for (auto it = range.first; it != range.second; it++) {
+            if (it->second == text_id) {
+                m_lookup.erase(it);
+                break;
+            }
+        }
+        m_free_texts.push_back(text_id);
+        m_trie.remove(text_id);
+    }
+
+    const u32 last = static_cast<u32>(m_words.size() - 1);
+    if (index != last) {
+        for (auto& word : m_text_words[m_words.text_id[last]]) {
+            if (word == last) {
+                word = index;
+                break;
+            }
+        }
+        m_words.x[index] = m_words.x[last];
+        m_words.y[index] = m_words.y[last];
+        m_words.speed[index] = m_words.speed[last];
+        m_words.width[index] = m_words.width[last];
+        m_words.last_step[index] = m_words.last_step[last];
+        m_words.highlight[index] = m_words.highlight[last];
+        m_words.text_id[index] = m_words.text_id[last];
+    }
+    m_words.x.pop_back();
+    m_words.y.pop_back();
+    m_words.speed.pop_back();
+    m_words.width.pop_back();
+    m_words.last_step.pop_back();
+    m_words.highlight.pop_back();
+    m_words.text_id.pop_back();
+}
+
+void Scroll_words::clear()
+{
+    m_words.x.clear();
+    m_words.y.clear();
+    m_words.speed.clear();
+    m_words.width.clear();
+    m_words.last_step.clear();
+    m_words.highlight.clear();
+    m_words.text_id.clear();
+    m_free_texts.clear();
+    for (u32 text_id = 0; text_id < m_text_words.size(); text_id++) {
+        m_text_words[text_id].clear();
+        m_free_texts.push_back(text_id);
+    }
+    m_lookup.clear();
+    m_trie.clear();
+}
+
+void Scroll_words::set_fold(bool fold)
+{
+    m_lookup.clear();
+    m_trie.clear();
+    for (u32 text_id = 0; text_id < m_text_words.size(); text_id++) {
+        if (m_text_words[text_id].empty()) continue;
+        Scroll_word_text& text = m_words.texts[text_id];
+        if (fold) fold_utf8(text.text, text.match_key, Word::text_size);
+        else memcpy(text.match_key, text.text, Word::text_size);
+        m_lookup.insert({std::string{text.match_key}, text_id});
+        m_text_highlight[text_id] = m_trie.insert(text_id, text.match_key);
+        for (const u32 index : m_text_words[text_id]) {
+            m_words.highlight[index] = m_text_highlight[text_id];
+        }
+    }
+    m_words.texts_version++;
+}
+
+u32 Scroll_words::find(const char* match_key) const
+{
+    u32 best = npos;
+    const auto range = m_lookup.equal_range(match_key);
+    for (auto it = range.first; it != range.second; it++) {
+        const u32 index = find_text(it->second);
+        if (best == npos || m_words.x[index] > m_words.x[best]) best = index;
+    }
+    return best;
+}
+
+u32 Scroll_words::find_text(u32 text_id) const
+{
+    u32 best = npos;
+    for (const u32 index : m_text_words[text_id]) {
+        if (best == npos || m_words.x[index] > m_words.x[best]) best = index;
+    }
+    return best;
+}
+
+bool Scroll_words::move(float screen_width)
+{
+    float* x = m_words.x.data();
+    const float* speed = m_words.speed.data();
+    float* last_step = m_words.last_step.data();
+    const size_t count = m_words.size();
+
+    size_t i = 0;
+    bool any_out = false;
+#if defined(TF_SCROLL_AVX)
+    const __m256 width8 = _mm256_set1_ps(screen_width);
+    int out8 = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 step = _mm256_loadu_ps(speed + i);
+        const __m256 moved = _mm256_add_ps(_mm256_loadu_ps(x + i), step);
+        _mm256_storeu_ps(x + i, moved);
+        _mm256_storeu_ps(last_step + i, step);
+        out8 |= _mm256_movemask_ps(_mm256_cmp_ps(moved, width8, _CMP_GT_OQ));
+    }
+    any_out |= out8 != 0;
+#endif
+#if defined(TF_SCROLL_SSE2)
+    const __m128 width4 = _mm_set1_ps(screen_width);
+    int out4 = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 step = _mm_loadu_ps(speed + i);
+        const __m128 moved = _mm_add_ps(_mm_loadu_ps(x + i), step);
+        _mm_storeu_ps(x + i, moved);
+        _mm_storeu_ps(last_step + i, step);
+        out4 |= _mm_movemask_ps(_mm_cmpgt_ps(moved, width4));
+    }
+    any_out |= out4 != 0;
+#endif
+    for (; i < count; i++) {
+        x[i] += speed[i];
+        last_step[i] = speed[i];
+        any_out |= x[i] > screen_width;
+    }
+    return any_out;
+}
+
+void Scroll_words::copy_to(Scroll_word_arrays& out) const
+{
+    out.x = m_words.x;
+    out.y = m_words.y;
+    out.speed = m_words.speed;
+    out.width = m_words.width;
+    out.last_step = m_words.last_step;
+    out.highlight = m_words.highlight;
+    out.text_id = m_words.text_id;
+    if (out.texts_version != m_words.texts_version || out.texts.size() != m_words.texts.size()) {
+        out.texts = m_words.texts;
+        out.texts_version = m_words.texts_version;
+    }
+}
+
+void Scroll_words::highlight(const char* input, u32 input_version)
+{
+    if (input_version == m_input_version) return;
+    m_input_version = input_version;
+
+    for (const Prefix_change& change : m_trie.set_input(input)) {
+        m_text_highlight[change.id] = change.count;
+        for (const u32 index : m_text_words[change.id]) {
+            m_words.highlight[index] = change.count;
+        }
+    }
+}
+
+// ============================================================ //
+// Draw
+// ============================================================ //
+
+void draw(Font* font, const Scroll_word_arrays& words, float alpha)
+{
+    for (size_t i = 0; i < words.size(); i++) {
+        const Scroll_word_text& text = words.texts[words.text_id[i]];
+        const Vector2 pos{words.x[i] - words.last_step[i] * (1.0f - alpha), words.y[i]};
+        draw_highlighted(font, text.text, text.metrics, words.highlight[i], pos,
+                         text.font_size, text.color, text.highlight_color);
+    }
+}
+
+}
@@ -0,0 +1,211 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2018 Christoffer Gustafsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __SCROLL_WORDS_HPP__
+#define __SCROLL_WORDS_HPP__
+
+// ============================================================ //
+// Headers
+// ============================================================ //
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "widget.hpp"
+#include "../util/prefix_trie.hpp"
+
+// ============================================================ //
+// Struct
+// ============================================================ //
+
+namespace tf
+{
+
+/**
+ * Text shared by every scrolling word that shows it, so duplicates are
+ * measured once.
+ */
+struct Scroll_word_text
+{
+    char text[Word::text_size];
+    // the text, or the folded text for case and diacritic insensitive
+    // matching, see fold_utf8
+    char match_key[Word::text_size];
+    Text_metrics<Word::text_size> metrics;
+    float font_size;
+    Color color;
+    Color highlight_color;
+};
+
+/**
+ * The scrolling words as one array per field, what a render snapshot copies.
+ * The arrays of words are all size() long, texts is indexed by text_id.
+ */
+struct Scroll_word_arrays
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    // pixels per tick
+    std::vector<float> speed;
+    std::vector<float> width;
+    // how far it moved in the last tick, used to interpolate between ticks
+    std::vector<float> last_step;
+    // codepoints matching the input
+    std::vector<int> highlight;
+    std::vector<u32> text_id;
+    std::vector<Scroll_word_text> texts;
+    // changes with texts, so copies only copy them when they changed
+    u32 texts_version = 0;
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+};
+
+// ============================================================ //
+// Class
+// ============================================================ //
+
+/**
+ * Words scrolling from left to right, stored densely so moving them is a
+ * loop over contiguous floats. Removing a word moves the last one into its
+ * place, so indices are only valid until the next remove. The same text can
+ * scroll any number of times.
+ */
+class Scroll_words
+{
+public:
+    static constexpr u32 npos = 0xFFFFFFFF;
+
+    /**
+     * Add a word at the position of @word.
+     * @param fold Fold the match key, see fold_utf8.
+     * @return Its index.
+     */
+    u32 add(Font* font, const Word& word, Color highlight_color, float speed, bool fold);
+
+    /**
+     * Remove the word at @index, the last word takes its place.
+     */
+    void remove(u32 index);
+
+    void clear();
+
+    /**
+     * Rebuild the match keys of the texts on screen, folded or not like the
+     * @fold of add. Highlights follow with the next highlight call.
+     */
+    void set_fold(bool fold);
+
+    /**
+     * @return The word matching @match_key that is furthest right, or npos.
+     */
+    u32 find(const char* match_key) const;
+
+    /**
+     * @return The word showing @text_id that is furthest right, or npos.
+     */
+    u32 find_text(u32 text_id) const;
+
+    /**
+     * Move every word one tick, the words that left the screen are passed to
+     * on_out(const Scroll_word_text&) and removed.
+     */
+    template <typename TFn>
+    void tick(float screen_width, TFn&& on_out)
+        {
+            if (!move(screen_width)) return;
+            // backwards, so the word swapped in has already been checked
+            for (size_t i = m_words.size(); i-- > 0;) {
+                if (m_words.x[i] > screen_width) {
+                    on_out(m_words.texts[m_words.text_id[i]]);
+                    remove(static_cast<u32>(i));
+                }
+            }
+        }
+
+    /**
+     * Call fn(text_id, const Scroll_word_text&) for every text on screen,
+     * until it returns false.
+     */
+    template <typename TFn>
+    void for_each_text(TFn&& fn) const
+        {
+            for (u32 text_id = 0; text_id < m_text_words.size(); text_id++) {
+                if (m_text_words[text_id].empty()) continue;
+                if (!fn(text_id, m_words.texts[text_id])) return;
+            }
+        }
+
+    /**
+     * Highlight the prefix of every word that matches @input. Only the words
+     * whose highlight changed since the last call are touched.
+     * @param input_version Nothing is done when it's the same as last time,
+     * see Text_input::version.
+     */
+    void highlight(const char* input, u32 input_version);
+
+    const Scroll_word_arrays& arrays() const { return m_words; }
+
+    /**
+     * Copy the words to @out, the texts only if they changed since @out got
+     * them.
+     */
+    void copy_to(Scroll_word_arrays& out) const;
+    const Scroll_word_text& text(u32 index) const
+        {
+            return m_words.texts[m_words.text_id[index]];
+        }
+    size_t size() const { return m_words.size(); }
+    bool empty() const { return m_words.empty(); }
+
+private:
+    /**
+     * x += speed for every word.
+     * @return If any word is past @screen_width.
+     */
+    bool move(float screen_width);
+
+    u32 add_text(Font* font, const Word& word, Color highlight_color, bool fold);
+
+    Scroll_word_arrays m_words{};
+    // by text id, indices of the words showing it, empty when the text is free
+    std::vector<std::vector<u32>> m_text_words{};
+    // by text id, codepoints of the match key matching the input
+    std::vector<int> m_text_highlight{};
+    // match keys by text id, follows the input for highlight
+    Prefix_trie m_trie{};
+    u32 m_input_version = ~0u;
+    std::vector<u32> m_free_texts{};
+    // match key to the ids of the texts with that key
+    std::unordered_multimap<std::string, u32> m_lookup{};
+};
+
+/**
+ * @param alpha How far into the next tick we are, 0-1, see H_scroll.
+ */
+void draw(Font* font, const Scroll_word_arrays& words, float alpha);
+
+}
+
+#endif//__SCROLL_WORDS_HPP__
@@ -26,9 +26,12 @@
 #include "../util/util.hpp"
 #include "../util/color.hpp"
 #include "../util/assert.hpp"
+#include "../util/fold.hpp"
+#include "../util/compat.hpp"
 #include "../thirdparty/filip/unicode.h"
 #include <cstring>
 #include <cstdlib>
+#include <cmath>
 #include <string>
 
 namespace tf
@@ -133,11 +136,20 @@ Slider create_slider(Rectangle rect, const char* format, Color color,
 
 void update(Word_formatter& formatter)
 {
+    if (formatter.version_fn) {
+        const u64 version = formatter.version_fn();
+        if (version == formatter.version) return;
+        formatter.version = version;
+    }
     formatter.format_fn(&formatter);
 }
 
-void update(Button<Word>& button, Vector2 mouse_pos, bool left_mouse_pressed)
+void update(Button<Word>& button, const Mouse_state& mouse)
 {
+    if (button.mouse_version == mouse.version) return;
+    button.mouse_version = mouse.version;
+
+    const Vector2 mouse_pos = mouse.pos;
     const auto x = button.rect.rect.x;
     const auto y = button.rect.rect.y;
     const bool cursor_inside =
@@ -151,86 +163,65 @@ void update(Button<Word>& button, Vector2 mouse_pos, bool left_mouse_pressed)
         button.hovering = false;
         button.rect.col_bg = button.col_bg;
     }
-    if (cursor_inside && left_mouse_pressed) {
+    if (cursor_inside && mouse.left_pressed) {
         button.on_pressed();
     }
 }
 
-void update(Input_box<Text_input<Word>>& input_box, std::vector<Event>& events)
+void update(Input_box<Text_input<Word>>& input_box, const Keystroke* keys,
+            size_t key_count, Frame_events& events)
 {
-    const int last_key = GetKeyPressed();
+    if (!input_box.text_input.active) return;
 
-    if (input_box.text_input.active) {
+    for (size_t i = 0; i < key_count; i++) {
+        const Keystroke& key = keys[i];
+        const u32 last_key = key.codepoint;
         // alpah keypress
-        if (last_key >= 33 && last_key <= 255 &&
+        if (key.kind == Keystroke_kind::text && last_key >= 33 && last_key <= 255 &&
             input_box.text_input.text_pos + 4 < input_box.text_input.text.text_size) {
             const int bytes = lnUTF8Encode(input_box.text_input.text.text +
                                            input_box.text_input.text_pos, last_key);
+            input_box.text_input.folded_pos += lnUTF8Encode(
+                input_box.text_input.folded + input_box.text_input.folded_pos,
+                fold_codepoint(last_key));
             if (input_box.text_input.text_pos == 0) { // first letter
                 events.push_back(Event::create_first_letter_input(
-                                     input_box.text_input.text.text,bytes));
+                                     input_box.text_input.text.text, bytes, key.time_us));
             }
             input_box.text_input.text_pos += bytes;
-
+            input_box.text_input.version++;
         }
         // backspace
-        else if (IsKeyPressed(KEY_BACKSPACE) && input_box.text_input.text_pos > 0) {
+        else if (key.kind == Keystroke_kind::backspace &&
+                 input_box.text_input.text_pos > 0) {
             const int bytes = lnUTF8Seek(input_box.text_input.text.text,
                                          input_box.text_input.text_pos);
             input_box.text_input.text_pos -= bytes;
             memset(input_box.text_input.text.text + input_box.text_input.text_pos,
                    0, bytes);
+            const int folded_bytes = lnUTF8Seek(input_box.text_input.folded,
+                                                input_box.text_input.folded_pos);
+            input_box.text_input.folded_pos -= folded_bytes;
+            memset(input_box.text_input.folded + input_box.text_input.folded_pos,
+                   0, folded_bytes);
+            input_box.text_input.version++;
         }
 
         // space or enter
-        else if ((IsKeyPressed(KEY_SPACE) || IsKeyPressed(KEY_ENTER))
+        else if (key.kind == Keystroke_kind::submit
                  && input_box.text_input.text_pos > 0) {
-            events.push_back(Event::create_word_input(input_box.text_input.text.text));
+            events.push_back(Event::create_word_input(input_box.text_input.text.text,
+                                                      key.time_us));
             input_box_clear(input_box);
         }
     }
 }
 
-void update(Text_highlightable<Word>& hl_text)
-{
-    const char* texta = hl_text.get_highlight_count();
-    const char* textb = hl_text.handle.text;
-    int matching = 0;
-    int pos = 0;
-    while (pos < hl_text.handle.text_size) {
-
-        u64 cpa, cpb;
-        u32 bytesa, bytesb;
-        const int valida = lnUTF8Decode(texta, pos, &cpa, &bytesa);
-        const int validb = lnUTF8Decode(textb, pos, &cpb, &bytesb);
-
-        if (valida + validb != 2 || cpa != cpb || bytesa != bytesb || cpa == 0) break;
-        else {
-            matching++;
-            pos += bytesa;
-        }
-    }
-
-    hl_text.highlight_count = matching;
-}
-
-bool update(H_scroll<Text_highlightable<Word>>& hscroll, float screen_width)
-{
-    if (hscroll.active) {
-        hscroll.drawable.handle.pos.x += hscroll.speed;
-        if (hscroll.drawable.handle.pos.x > screen_width) {
-            hscroll.on_out(&hscroll);
-            return true;
-        }
-        update(hscroll.drawable);
-    }
-    return false;
-}
-
 bool update(H_scroll<Rect>& hscroll, float screen_width)
 {
     if (hscroll.active) {
         hscroll.drawable.rect.x += hscroll.speed;
+        hscroll.last_step = hscroll.speed;
         if (hscroll.drawable.rect.x > screen_width) {
             hscroll.on_out(&hscroll);
             return true;
@@ -239,8 +230,13 @@ bool update(H_scroll<Rect>& hscroll, float screen_width)
     return false;
 }
 
-void update(Slider& slider, Vector2 mouse_pos, bool left_mouse_down)
+void update(Slider& slider, const Mouse_state& mouse)
 {
+    if (slider.mouse_version == mouse.version) return;
+    slider.mouse_version = mouse.version;
+
+    const Vector2 mouse_pos = mouse.pos;
+    const bool left_mouse_down = mouse.left_down;
     if (left_mouse_down && !slider.held && slider.active) {
 
         if (inside(mouse_pos.x, slider.marker.x,
@@ -270,44 +266,47 @@ void update(Slider& slider, Vector2 mouse_pos, bool left_mouse_down)
     }
 }
 
+void slider_set_value(Slider& slider, int value)
+{
+    slider.value = clamp(value, slider.min_value, slider.max_value);
+    slider_update_markerx(slider);
+    const int sprintf_res = sprintf_s(slider.title.text, slider.title.text_size,
+                                      slider.template_title, slider.value);
+    tf_assert(sprintf_res != 0, "sprintf error");
+    slider.on_change(slider);
+}
+
 // ============================================================ //
 
 void draw(Font* font, const Word& word)
 {
-    DrawTextEx(*font, word.text, word.pos, word.font_size, text_spacing, word.color);
+    platform::draw_text(*font, word.text, word.pos, word.font_size, text_spacing, word.color);
 }
 
 void draw(Font* font, const Text& text)
 {
-    DrawTextEx(*font, text.text, text.pos, text.font_size, text_spacing, text.color);
+    platform::draw_text(*font, text.text, text.pos, text.font_size, text_spacing, text.color);
 }
 
-void draw(Font* font, const Text_highlightable<Word>& hl_text)
+void draw_highlighted(Font* font, const char* text, const Text_metrics<Word::text_size>& metrics,
+                      int hlcount, Vector2 text_pos, float font_size, Color color,
+                      Color highlight_color)
 {
-    const int hlcount = hl_text.highlight_count;
-    if (hlcount == 0) draw(font, hl_text.handle);
+    if (hlcount == 0) {
+        platform::draw_text(*font, text, text_pos, font_size, text_spacing, color);
+    }
     else {
-        const auto textlen = lnUTF8StringLength(hl_text.handle.text);
-        if (textlen != hlcount) {
-            char* const text1 = lnUTF8Substring(hl_text.handle.text, 0, hlcount);
-            DrawTextEx(*font, text1, hl_text.handle.pos, hl_text.handle.font_size,
-                       text_spacing, hl_text.highlight_color);
-
-
-            if (hlcount < textlen) {
-                char* const text2 = lnUTF8SubstringFrom(hl_text.handle.text, hlcount);
-                const Vector2 hltextlen = MeasureTextEx(*font, text1, hl_text.handle.font_size,
-                                                        text_spacing);
-                const Vector2 pos{hl_text.handle.pos.x+hltextlen.x, hl_text.handle.pos.y};
-                DrawTextEx(*font, text2, pos, hl_text.handle.font_size,
-                           text_spacing, hl_text.handle.color);
-                free(text2);
-            }
-            free(text1);
+        if (hlcount < metrics.length) {
+            const int bytes = metrics.offsets[hlcount];
+            draw_text(font, text, bytes, text_pos, font_size, highlight_color);
+
+            // the rest is null terminated already, draw it straight away
+            const Vector2 pos{text_pos.x + metrics.advances[hlcount], text_pos.y};
+            platform::draw_text(*font, text + bytes, pos, font_size, text_spacing, color);
         }
         else { // Only the highlighted color will be drawn, so dont make substring
-            DrawTextEx(*font, hl_text.handle.text, hl_text.handle.pos, hl_text.handle.font_size,
-                       text_spacing, hl_text.highlight_color);
+            platform::draw_text(*font, text, text_pos, font_size, text_spacing,
+                                highlight_color);
         }
     }
 }
@@ -317,11 +316,13 @@ void draw(Font* font, const Word_formatter& formatter)
     draw(font, formatter.handle);
 }
 
-void draw(Font* font, const Rect& rect)
+void draw(Font* font, const Rect& rect, float offset_x)
 {
-    DrawRectangleRec(rect.rect, rect.col_bg);
+    const Rectangle moved{rect.rect.x + offset_x, rect.rect.y, rect.rect.width,
+                          rect.rect.height};
+    platform::draw_rectangle(moved, rect.col_bg);
     if (rect.outline_thickness > 0) {
-        DrawRectangleLinesEx(rect.rect, rect.outline_thickness, rect.col_outline);
+        platform::draw_rectangle_lines(moved, rect.outline_thickness, rect.col_outline);
     }
 }
 
@@ -336,14 +337,12 @@ void draw(Font* font, const Text_input<Word>& text_input)
     // text
     float width = 0;
     if (text_input.text_pos > 0) {
-        char* text = lnUTF8Substring(text_input.text.text, 0, text_input.text_pos);
-        tf_assert(text, "Failed to create substring");
-        DrawTextEx(*font, text, text_input.text.pos, text_input.text.font_size,
-                   text_spacing, text_input.text.color);
+        draw_text(font, text_input.text.text, text_input.text_pos, text_input.text.pos,
+                  text_input.text.font_size, text_input.text.color);
         if (text_input.active) {
-            width = MeasureTextEx(*font, text, text_input.text.font_size, text_spacing).x;
+            width = measure_text(font, text_input.text.text, text_input.text_pos,
+                                 text_input.text.font_size).x;
         }
-        free(text);
     }
 
     // marker
@@ -354,7 +353,7 @@ void draw(Font* font, const Text_input<Word>& text_input)
             text_input.text.pos.y + text_input.text.font_size - height*2,
             text_input.text.font_size/2.0f,
             height};
-        DrawRectangleRec(rect, text_input.col_marker);
+        platform::draw_rectangle(rect, text_input.col_marker);
     }
 }
 
@@ -367,21 +366,57 @@ void draw(Font* font, const Input_box<Text_input<Word>>& input_box)
 void draw(Font* font, const Slider& slider)
 {
     draw(font, slider.title);
-    DrawLineV(slider.lmarker.a, slider.lmarker.b, col_darkerblue);
-    DrawLineV(slider.rmarker.a, slider.rmarker.b, col_darkerblue);
-    DrawLineV(slider.line.a, slider.line.b, col_darkerblue);
-    DrawRectangleRec(slider.marker, slider.color);
+    platform::draw_line(slider.lmarker.a, slider.lmarker.b, col_darkerblue);
+    platform::draw_line(slider.rmarker.a, slider.rmarker.b, col_darkerblue);
+    platform::draw_line(slider.line.a, slider.line.b, col_darkerblue);
+    platform::draw_rectangle(slider.marker, slider.color);
+}
+
+void draw_text(Font* font, const char* text, size_t bytes, Vector2 pos,
+               float font_size, Color color)
+{
+    if (text[bytes] == 0) { // already null terminated
+        platform::draw_text(*font, text, pos, font_size, text_spacing, color);
+        return;
+    }
+    char buf[constants::text_size];
+    const size_t size = bytes < sizeof(buf) ? bytes : sizeof(buf) - 1;
+    memcpy(buf, text, size);
+    buf[size] = 0;
+    platform::draw_text(*font, buf, pos, font_size, text_spacing, color);
+}
+
+Vector2 measure_text(Font* font, const char* text, size_t bytes, float font_size)
+{
+    if (text[bytes] == 0) { // already null terminated
+        return platform::measure_text(*font, text, font_size, text_spacing);
+    }
+    char buf[constants::text_size];
+    const size_t size = bytes < sizeof(buf) ? bytes : sizeof(buf) - 1;
+    memcpy(buf, text, size);
+    buf[size] = 0;
+    return platform::measure_text(*font, buf, font_size, text_spacing);
 }
 
 // ============================================================ //
 
-void H_scroll_set_width(Font* font, H_scroll<Text_highlightable<Word>>& hs)
+void measure_metrics(Font* font, const char* text, float font_size,
+                     Text_metrics<Word::text_size>& metrics)
 {
-    const Vector2 len = MeasureTextEx(
-        *font,
-        hs.drawable.handle.text,
-        hs.drawable.handle.font_size, text_spacing);
-    hs.width = len.x;
+    int length = 0;
+    int pos = 0;
+    metrics.offsets[0] = 0;
+    metrics.advances[0] = 0.0f;
+    while (pos < Word::text_size && text[pos] != 0) {
+        u64 codepoint;
+        u32 bytes;
+        if (!lnUTF8Decode(text, pos, &codepoint, &bytes)) break;
+        pos += bytes;
+        length++;
+        metrics.offsets[length] = static_cast<u8>(pos);
+        metrics.advances[length] = measure_text(font, text, pos, font_size).x;
+    }
+    metrics.length = length;
 }
 
 void input_box_clear(Input_box<Text_input<Word>>& input_box)
@@ -389,6 +424,9 @@ void input_box_clear(Input_box<Text_input<Word>>& input_box)
     const auto len = strlen(input_box.text_input.text.text);
     memset(input_box.text_input.text.text, 0, len);
     input_box.text_input.text_pos = 0;
+    memset(input_box.text_input.folded, 0, input_box.text_input.folded_pos);
+    input_box.text_input.folded_pos = 0;
+    input_box.text_input.version++;
 }
 
 void widget_debug_print_sizes()
@@ -398,8 +436,6 @@ void widget_debug_print_sizes()
     printf("= Text\t%zi\n", sizeof(Text));
     printf("= Word_formatter<Word> /wo Word\t%zi\n", sizeof(Word_formatter) - sizeof(Word));
     printf("= Word_formatter<Text> /wo Text\t%zi\n", sizeof(Word_formatter) - sizeof(Text));
-    printf("= Text_highlightable<T>\t%zi\n", sizeof(Text_highlightable<Word>) -
-           sizeof(Word));
     printf("= H_scroll<T>\t%zi\n", sizeof(H_scroll<Word>) - sizeof(Word));
     printf("= Rect\t%zi\n", sizeof(Rect));
     printf("= Button<T>\t%zi\n", sizeof(Button<Word>) - sizeof(Word));
@@ -33,7 +33,9 @@
 #include <vector>
 #include <cstdint>
 #include "constants.hpp"
-#include "../event.hpp"
+#include "../platform/platform.hpp"
+#include "../event_buffer.hpp"
+#include "../util/key_capture.hpp"
 
 // ============================================================ //
 // Struct
@@ -67,17 +69,38 @@ struct Word_formatter {
      * sprintf_s(wf->handle.text, wf->handle.text_size, "text %d", value);
      */
     void (*format_fn)(Word_formatter*);
+    /**
+     * Returns anything that changes whenever the formatted text would, like
+     * a change counter or the value as it is printed. format_fn is only
+     * called when it changed. Without it, format_fn is called every update.
+     */
+    u64 (*version_fn)() = nullptr;
+    u64 version = ~0ull;
 };
 
 /**
- *
+ * The mouse as the widgets see it, version changes whenever anything else
+ * does. Widgets remember the version they last saw and skip the update when
+ * it's the same.
  */
-template <typename TText>
-struct Text_highlightable {
-    TText handle;
-    Color highlight_color;
-    int highlight_count;
-    const char* (*get_highlight_count)();
+struct Mouse_state {
+    Vector2 pos{};
+    bool left_pressed = false;
+    bool left_down = false;
+    u32 version = 1;
+};
+
+/**
+ * Byte offset and drawn width of the first n codepoints of a text, so that
+ * substrings and widths are lookups instead of walks over the string.
+ * Scrolling words keep one per distinct text in Scroll_word_text, filled by
+ * measure_metrics when the text is first spawned.
+ */
+template <int TSize>
+struct Text_metrics {
+    int length; // in codepoints
+    u8 offsets[TSize]; // byte offset of codepoint n, offsets[length] is the size
+    float advances[TSize]; // width of the first n codepoints
 };
 
 /**
@@ -87,12 +110,13 @@ template <typename TDrawable>
 struct H_scroll {
     TDrawable drawable;
     float speed;
-    /**
-     * If TDrawable is text, use the H_scroll_set_width helper function to set it.
-     */
     float width;
     bool active;
     void (*on_out)(H_scroll<TDrawable>*);
+    /**
+     * How far it moved in the last tick, used to interpolate between ticks.
+     */
+    float last_step = 0;
 };
 
 /**
@@ -117,6 +141,7 @@ struct Button {
     Color col_hover;
     void (*on_pressed)();
     bool hovering = false;
+    u32 mouse_version = 0;
 };
 
 /**
@@ -129,6 +154,11 @@ struct Text_input {
     Color col_marker;
     float max_width;
     bool active;
+    // text folded one keystroke at a time, see fold_codepoint
+    char folded[TText::text_size];
+    int folded_pos;
+    // changes with the text
+    u32 version;
 };
 
 template <typename TText_input>
@@ -164,6 +194,7 @@ struct Slider {
     bool active;
     bool held;
     void (*on_change)(Slider&);
+    u32 mouse_version;
 };
 
 // ============================================================ //
@@ -190,43 +221,82 @@ Slider create_slider(Rectangle rect, const char* format, Color color,
 // ============================================================ //
 
 void update(Word_formatter& word_formatter);
-void update(Button<Word>& button, Vector2 mouse_pos, bool left_mouse_pressed);
+void update(Button<Word>& button, const Mouse_state& mouse);
 /**
+ * @param keys Keystrokes since the last update, oldest first.
  * @param events Where to put the events that might be generated.
  */
-void update(Input_box<Text_input<Word>>& input_box, std::vector<Event>& events);
-void update(Text_highlightable<Word>& word_hl_scoll);
-
+void update(Input_box<Text_input<Word>>& input_box, const Keystroke* keys,
+            size_t key_count, Frame_events& events);
 /**
+ * Move it one simulation tick.
  * @return If it left the screen
  */
-bool update(H_scroll<Text_highlightable<Word>>& hscroll, float screen_width);
 bool update(H_scroll<Rect>& hscroll, float screen_width);
 
-void update(Slider& slider, Vector2 mouse_pos, bool left_mouse_down);
+void update(Slider& slider, const Mouse_state& mouse);
+
+/**
+ * Move the slider to @value as if it was dragged there, calls on_change.
+ */
+void slider_set_value(Slider& slider, int value);
 
 // ============================================================ //
 
 void draw(Font* font, const Word& word);
 void draw(Font* font, const Text& text);
-void draw(Font* font, const Text_highlightable<Word>& hl_text);
 void draw(Font* font, const Word_formatter& word_formatter);
 template <typename TDrawable>
-inline void draw(Font* font, const H_scroll<TDrawable>& TDrawable)
+inline void draw(Font* font, const H_scroll<TDrawable>& hscroll)
 {
-    if (TDrawable.active) {
-        draw(font, TDrawable.drawable);
+    if (hscroll.active) {
+        draw(font, hscroll.drawable);
     }
 }
-void draw(Font* font, const Rect& rect);
+/**
+ * @param alpha How far into the next tick we are, 0-1. It's drawn between
+ * where it was before the last tick and where it is now.
+ */
+template <typename TDrawable>
+inline void draw(Font* font, const H_scroll<TDrawable>& hscroll, float alpha)
+{
+    if (hscroll.active) {
+        draw(font, hscroll.drawable, -hscroll.last_step * (1.0f - alpha));
+    }
+}
+void draw(Font* font, const Rect& rect, float offset_x = 0);
 void draw(Font* font, const Button<Word>& button);
 void draw(Font* font, const Text_input<Word>& text_input);
 void draw(Font* font, const Input_box<Text_input<Word>>& input_box);
 void draw(Font* font, const Slider& slider);
 
-// ============================================================ //
+/**
+ * Draw the first @bytes of @text, it does not have to be null terminated.
+ * Does not allocate, text longer than constants::text_size is cut.
+ */
+void draw_text(Font* font, const char* text, size_t bytes, Vector2 pos,
+               float font_size, Color color);
 
-void H_scroll_set_width(Font* font, H_scroll<Text_highlightable<Word>>& hs);
+/**
+ * Measure the first @bytes of @text, it does not have to be null terminated.
+ * Does not allocate, text longer than constants::text_size is cut.
+ */
+Vector2 measure_text(Font* font, const char* text, size_t bytes, float font_size);
+
+/**
+ * Draw @text with its first @highlight_count codepoints in @highlight_color.
+ */
+void draw_highlighted(Font* font, const char* text, const Text_metrics<Word::text_size>& metrics,
+                      int highlight_count, Vector2 pos, float font_size, Color color,
+                      Color highlight_color);
+
+/**
+ * Measure the codepoint offsets and widths of @text, a Word::text_size buffer.
+ */
+void measure_metrics(Font* font, const char* text, float font_size,
+                     Text_metrics<Word::text_size>& metrics);
+
+// ============================================================ //
 
 void input_box_clear(Input_box<Text_input<Word>>& input_box);
 
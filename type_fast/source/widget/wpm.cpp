@@ -31,43 +31,60 @@ namespace tf
 
 void Wpm::word_input(const size_t word_size)
 {
-    this->last_update = std::chrono::high_resolution_clock::now();
+    word_input(word_size, 0, now_us());
+}
+
+void Wpm::word_input(const size_t word_size, const int edits)
+{
+    word_input(word_size, edits, now_us());
+}
+
+void Wpm::word_input(const size_t word_size, const int edits, const u64 time_us)
+{
     this->word_count++;
     this->word_total_length += word_size;
+    this->edit_count += edits;
+    // up to the keystroke that finished the word, not the frame handling it
+    this->active_time = std::chrono::duration_cast<std::chrono::microseconds>(
+        from_us(time_us) - start_time - inactive_time);
 }
 
 void Wpm::first_letter_input()
+{
+    first_letter_input(now_us());
+}
+
+void Wpm::first_letter_input(const u64 time_us)
 {
     if (!this->has_begun)
-        this->inactive_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::high_resolution_clock::now() - start_time);
+        this->inactive_time = std::chrono::duration_cast<std::chrono::microseconds>(
+            from_us(time_us) - start_time);
     this->has_begun = true;
 }
 
-void Wpm::update()
+void Wpm::reset()
 {
-    this->active_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::high_resolution_clock::now() - start_time - inactive_time);
+    reset(now_us());
 }
 
-void Wpm::reset()
+void Wpm::reset(const u64 time_us)
 {
     this->word_count = 0;
     this->word_total_length = 0;
-    this->last_update = std::chrono::high_resolution_clock::now();
-    this->start_time = std::chrono::high_resolution_clock::now();
-    this->active_time = std::chrono::milliseconds(0);
-    this->inactive_time = std::chrono::milliseconds(0);
+    this->edit_count = 0;
+    this->start_time = from_us(time_us);
+    this->active_time = std::chrono::microseconds(0);
+    this->inactive_time = std::chrono::microseconds(0);
     this->has_begun = false;
 }
 
 static inline float _wpm(u64 active_time, u64 word_count)
 {
-    const float ms_per_word =
+    const float us_per_word =
         static_cast<float>(active_time) / word_count;
-    constexpr float ms_per_minute = 60 * 1000;
+    constexpr float us_per_minute = 60 * 1000 * 1000;
 
-    return ms_per_minute / ms_per_word;
+    return us_per_minute / us_per_word;
 }
 
 float Wpm::get_wpm() const
@@ -31,7 +31,9 @@
 
 #include "widget.hpp"
 #include "util/types.hpp"
+#include "util/clock.hpp"
 #include <chrono>
+#include <cstring>
 
 // ============================================================ //
 // Class
@@ -50,6 +52,18 @@ public:
      */
     void word_input(const size_t word_size);
 
+    /**
+     * Call when a word was accepted with typos, @edits is how many edits
+     * away from the word the input was.
+     */
+    void word_input(const size_t word_size, const int edits);
+
+    /**
+     * Like above, but at the time the word was submitted, see now_us. The
+     * wpm counts the time up to here.
+     */
+    void word_input(const size_t word_size, const int edits, const u64 time_us);
+
     /**
      * Call when the first letter was entered. Used to detect when the player
      * goes afk.
@@ -57,12 +71,25 @@ public:
     void first_letter_input();
 
     /**
-     * Call contineously to update the internal clocks.
+     * Like above, but at the time the key was pressed, see now_us.
      */
-    void update();
+    void first_letter_input(const u64 time_us);
+
+    // ============================================================ //
+    // Events
+    // ============================================================ //
+    void on_event(const Event_word_hit& event)
+        { word_input(std::strlen(event.word), event.edits, event.time_us); }
+    void on_event(const Event_first_letter_input& event)
+        { first_letter_input(event.time_us); }
 
     void reset();
 
+    /**
+     * Start over at @time_us, see now_us.
+     */
+    void reset(const u64 time_us);
+
     float get_wpm() const;
 
     /**
@@ -71,19 +98,23 @@ public:
      */
     float get_adjusted_wpm() const;
 
+    /**
+     * Total number of edits in words accepted with typos.
+     */
+    u64 get_edit_count() const { return edit_count; }
+
 private:
     u64 word_count = 0;
     u64 word_total_length = 0;
+    u64 edit_count = 0;
     static constexpr float word_adjusted_length = 4.0f;
-    std::chrono::time_point<std::chrono::high_resolution_clock> last_update{
-        std::chrono::high_resolution_clock::now()
-    };
     std::chrono::time_point<std::chrono::high_resolution_clock> start_time{
         std::chrono::high_resolution_clock::now()
     };
 
-    std::chrono::milliseconds active_time{0};
-    std::chrono::milliseconds inactive_time{0};
+    // until the last word, so the wpm has the keystrokes' resolution
+    std::chrono::microseconds active_time{0};
+    std::chrono::microseconds inactive_time{0};
 
     /**
      * We only start the wpm counter once the player has entered a letter.